@@ -540,6 +540,8 @@ QString cTranslator::engText[] =
 	"Refer to device datasheet, please",
 	"Checked items means programmed",
 	"UnChecked items means unprogrammed",
+
+	"Use the device minimum SPI timing",
 	""
 };
 
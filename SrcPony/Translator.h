@@ -479,6 +479,8 @@ enum TR_CONSTS
 	STR_LBLFUSEDLGHLP,
 	STR_FUSEDLGNOTESET,
 	STR_FUSEDLGNOTECLR,
+
+	STR_LBLSPIMINTIMING,
 	STR_ENUM_SIZE
 };
 
@@ -129,7 +129,7 @@ int At17xxx::Write(int probe, int type)
 				break;
 			}
 
-			if (GetBus()->WriteProgress(j * 100 / size))
+			if (GetBus()->WriteProgress(j, size))
 			{
 				rval = OP_ABORTED;
 				break;
@@ -256,7 +256,7 @@ int At17xxx::Read(int probe, int type)
 				break;
 			}
 
-			if (GetBus()->ReadProgress(k * 100 / size))
+			if (GetBus()->ReadProgress(k, size))
 			{
 				error = OP_ABORTED;
 				break;
@@ -314,6 +314,12 @@ int At17xxx::Verify(int type)
 
 		for (k = 0; k < size; k += readpage_size)
 		{
+			//skip the pages the loaded file didn't populate
+			if (GetBus()->UsedLength(GetBufPtr() + k, readpage_size) == 0)
+			{
+				continue;
+			}
+
 			rval = ReadPage(k, addr_bytes, localbuf, readpage_size);
 
 			if (rval != OK)
@@ -321,6 +327,8 @@ int At17xxx::Verify(int type)
 				break;
 			}
 
+			GetBus()->MaskUnused(GetBufPtr() + k, localbuf, readpage_size);
+
 			if (memcmp(GetBufPtr() + k, localbuf, readpage_size) != 0)
 			{
 				rval = 0;
@@ -331,7 +339,7 @@ int At17xxx::Verify(int type)
 				rval = 1;
 			}
 
-			if (GetBus()->ReadProgress(k * 100 / size))
+			if (GetBus()->ReadProgress(k, size))
 			{
 				rval = OP_ABORTED;
 				break;
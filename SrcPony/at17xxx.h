@@ -38,6 +38,12 @@ class At17xxx : public E24xx
 	//      int Probe(int probe_size = 0);
 	int Read(int probe = 1, int type = ALL_TYPE);
 	int Write(int probe = 1, int type = ALL_TYPE);
+
+	bool CanDeltaWrite() const
+	{
+		return false;
+	}
+
 	int Verify(int type = ALL_TYPE);
 
   protected:    //--------------------------------------- protected
@@ -45,6 +51,11 @@ class At17xxx : public E24xx
 	int WritePage(long addr, int addr_bytes, uint8_t *buf, int len);
 	int ReadPage(long addr, int addr_bytes, uint8_t *buf, int len);
 
+	int GetAddrBytes() const
+	{
+		return 0;
+	}
+
   private:              //--------------------------------------- private
 
 };
@@ -124,12 +124,18 @@ int At250Bus::WaitEndOfWrite(int timeout)               // 07/08/99
 		timeout = loop_timeout;
 	}
 
-	int k;
+	PollStart(POLL_WRITE, timeout);
 
-	for (k = timeout; k > 0 && (ReadEEPStatus() & NotReadyFlag); k--)
-		;
+	while (PollWait())
+	{
+		if (!(ReadEEPStatus() & NotReadyFlag))
+		{
+			PollReady();
+			return 1;
+		}
+	}
 
-	return (k != 0);
+	return 0;
 }
 
 int At250Bus::Reset(void)
@@ -161,7 +167,7 @@ long At250Bus::Read(int addr, uint8_t *data, long length, int page_size)
 
 		if ((len % 10) == 0)
 		{
-			if (ReadProgress(len * 100 / length))
+			if (ReadProgress(len, length))
 			{
 				break;
 			}
@@ -188,21 +194,24 @@ long At250Bus::Write(int addr, uint8_t const *data, long length, int page_size)
 		return 0;
 	}
 
-	for (len = 0; len < length; len++)
+	for (len = 0; len < length; len++, addr++, data++)
 	{
-		SendDataByte(WriteEnable);
-		EndCycle();
+		if (!IsUnused(data, 1) && !IsUnchanged(data, 1))
+		{
+			SendDataByte(WriteEnable);
+			EndCycle();
 
-		WriteEEPByte(addr++, *data++);
+			WriteEEPByte(addr, *data);
 
-		if (!WaitEndOfWrite())
-		{
-			return 0;        //Must return 0, because > 0 (and != length) means "Abort by user"
+			if (!WaitEndOfWrite())
+			{
+				return 0;        //Must return 0, because > 0 (and != length) means "Abort by user"
+			}
 		}
 
 		if ((len & 1))
 		{
-			if (WriteProgress(len * 100 / length))
+			if (WriteProgress(len, length))
 			{
 				break;
 			}
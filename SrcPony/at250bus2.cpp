@@ -67,7 +67,7 @@ long At250BigBus::Read(int addr, uint8_t *data, long length, int page_size)
 
 		if ((len % 10) == 0)
 		{
-			if (ReadProgress(len * 100 / length))
+			if (ReadProgress(len, length))
 			{
 				break;
 			}
@@ -103,6 +103,12 @@ long At250BigBus::Write(int addr, uint8_t const *data, long length, int page_siz
 	long count = 0;
 	for (len = 0; len < length; len += writepage_size, addr += writepage_size)
 	{
+		if (IsUnused(data, writepage_size) || IsUnchanged(data, writepage_size))
+		{
+			data += writepage_size;
+			continue;
+		}
+
 		SendDataByte(WriteEnable);
 		EndCycle();
 
@@ -126,7 +132,7 @@ long At250BigBus::Write(int addr, uint8_t const *data, long length, int page_siz
 
 		if ((++count & 1))
 		{
-			if (WriteProgress(len * 100 / length))
+			if (WriteProgress(len, length))
 			{
 				break;
 			}
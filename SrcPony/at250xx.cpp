@@ -142,6 +142,7 @@ int At250xx::Verify(int type)
 		}
 		else
 		{
+			GetBus()->MaskUnused(GetBufPtr(), localbuf, size);
 			rval = (memcmp(GetBufPtr(), localbuf, size) != 0) ? 0 : 1;
 		}
 	}
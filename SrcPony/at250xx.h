@@ -43,6 +43,12 @@ class At250xx : public Device
 	virtual int Probe(int probe_size = 0);
 	virtual int Read(int probe = 1, int type = ALL_TYPE);
 	virtual int Write(int probe = 1, int type = ALL_TYPE);
+
+	bool CanDeltaWrite() const
+	{
+		return true;
+	}
+
 	virtual int Verify(int type = ALL_TYPE);
 
   protected:    //--------------------------------------- protected
@@ -520,7 +520,7 @@ long At89sBus::Read(int addr, uint8_t *data, long length, int page_size)
 			{
 				ReadDataPage(addr, data, page_size);
 
-				if (ReadProgress(len * 100 / length))
+				if (ReadProgress(len, length))
 				{
 					break;
 				}
@@ -532,7 +532,7 @@ long At89sBus::Read(int addr, uint8_t *data, long length, int page_size)
 			{
 				*data++ = (uint8_t)ReadDataByte(addr++);
 
-				if (ReadProgress(len * 100 / length))
+				if (ReadProgress(len, length))
 				{
 					break;
 				}
@@ -548,7 +548,7 @@ long At89sBus::Read(int addr, uint8_t *data, long length, int page_size)
 			{
 				ReadProgPage(addr, data, page_size);
 
-				if (ReadProgress(len * 100 / length))
+				if (ReadProgress(len, length))
 				{
 					break;
 				}
@@ -560,7 +560,7 @@ long At89sBus::Read(int addr, uint8_t *data, long length, int page_size)
 			{
 				*data++ = (uint8_t)ReadProgByte(addr++);
 
-				if (ReadProgress(len * 100 / length))
+				if (ReadProgress(len, length))
 				{
 					break;
 				}
@@ -576,9 +576,10 @@ long At89sBus::Read(int addr, uint8_t *data, long length, int page_size)
 int At89sBus::WaitReadyAfterWrite(int type, long addr, int data, long timeout)
 {
 	int rval = E2P_TIMEOUT;
-	int k;
 
-	for (k = 0; k < timeout; k++)
+	PollStart(type ? POLL_WRITE : POLL_PROG, timeout);
+
+	while (PollWait())
 	{
 		int val;
 
@@ -593,6 +594,7 @@ int At89sBus::WaitReadyAfterWrite(int type, long addr, int data, long timeout)
 
 		if (val == data)
 		{
+			PollReady();
 			rval = OK;
 			break;
 		}
@@ -635,7 +637,7 @@ long At89sBus::Write(int addr, uint8_t const *data, long length, int page_size)
 					return E2ERR_WRITEFAILED;
 				}
 
-				if (WriteProgress(len * 100 / length))
+				if (WriteProgress(len, length))
 				{
 					break;
 				}
@@ -666,7 +668,7 @@ long At89sBus::Write(int addr, uint8_t const *data, long length, int page_size)
 					}
 				}
 
-				if (WriteProgress(len * 100 / length))
+				if (WriteProgress(len, length))
 				{
 					break;
 				}
@@ -687,7 +689,7 @@ long At89sBus::Write(int addr, uint8_t const *data, long length, int page_size)
 						return E2ERR_WRITEFAILED;
 					}
 
-				if (WriteProgress(len * 100 / length))
+				if (WriteProgress(len, length))
 				{
 					break;
 				}
@@ -718,7 +720,7 @@ long At89sBus::Write(int addr, uint8_t const *data, long length, int page_size)
 					}
 				}
 
-				if (WriteProgress(len * 100 / length))
+				if (WriteProgress(len, length))
 				{
 					break;
 				}
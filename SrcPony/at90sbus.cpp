@@ -48,6 +48,8 @@ At90sBus::At90sBus(BusInterface *ptr)
 	  WriteProgPageMem(0x4C),
 	  ReadEEPMem0(0xA0), ReadEEPMem1(0),
 	  WriteEEPMem0(0xC0), WriteEEPMem1(0),
+	  LoadEEPPage0(0xC1), LoadEEPPage1(0),
+	  WriteEEPPage0(0xC2), WriteEEPPage1(0),
 	  ReadDevCode0(0x30), ReadDevCode1(0),
 	  ReadLock0(0x58), ReadLock1(0),
 	  WriteLock0(0xAC), WriteLock1(0xE0),
@@ -58,9 +60,12 @@ At90sBus::At90sBus(BusInterface *ptr)
 	  ReadFuseExt0(0x50), ReadFuseExt1(0x08),
 	  WriteFuseExt0(0xAC), WriteFuseExt1(0xA4),
 	  ReadCalib0(0x38), ReadCalib1(0),
+	  PollRdyBsy0(0xF0), PollRdyBsy1(0),
 	  p1_a(0x80), p2_a(0x7F), pflash_a(0x7F),
 	  p1_b(0x00), p2_b(0xFF), pflash_b(0xFF),
-	  old1200mode(false)
+	  old1200mode(false),
+	  enable_flashpage_polling(true),
+	  enable_rdybsy_polling(false)
 {
 	qDebug() << "At90sBus::At90sBus()";
 
@@ -70,11 +75,22 @@ At90sBus::At90sBus(BusInterface *ptr)
 }
 
 //limit EEPROM size to 64K max
+//Read Data Memory instruction of the byte at addr
+void At90sBus::EEPReadCmd(long addr, uint8_t *cmd) const
+{
+	cmd[0] = ReadEEPMem0;
+	cmd[1] = ReadEEPMem1 | ((addr & 0xFFFF) >> 8);        //19/01/1999 -- the bug is due to an error in the original Atmel datasheet
+	cmd[2] = (uint8_t)addr;
+}
+
 int At90sBus::ReadEEPByte(long addr)
 {
-	SendDataByte(ReadEEPMem0);
-	SendDataByte(ReadEEPMem1 | ((addr & 0xFFFF) >> 8));     //19/01/1999 -- the bug is due to an error in the original Atmel datasheet
-	SendDataByte(addr);
+	uint8_t cmd[3];
+
+	EEPReadCmd(addr, cmd);
+	SendDataByte(cmd[0]);
+	SendDataByte(cmd[1]);
+	SendDataByte(cmd[2]);
 
 	return RecDataByte();
 }
@@ -88,7 +104,8 @@ void At90sBus::WriteEEPByte(long addr, int data)
 }
 
 
-int At90sBus::ReadProgByte(long addr)
+//Read Program Memory instruction of the byte at addr
+void At90sBus::ProgReadCmd(long addr, uint8_t *cmd) const
 {
 	int lsb = addr & 1;
 	addr >>= 1;             //convert to word address
@@ -101,16 +118,26 @@ int At90sBus::ReadProgByte(long addr)
 	if (lsb)
 #endif
 	{
-		SendDataByte(ReadProgMemH0);
-		SendDataByte(ReadProgMemH1 | (addr >> 8));
+		cmd[0] = ReadProgMemH0;
+		cmd[1] = ReadProgMemH1 | (addr >> 8);
 	}
 	else
 	{
-		SendDataByte(ReadProgMemL0);
-		SendDataByte(ReadProgMemL1 | (addr >> 8));
+		cmd[0] = ReadProgMemL0;
+		cmd[1] = ReadProgMemL1 | (addr >> 8);
 	}
 
-	SendDataByte(addr);
+	cmd[2] = (uint8_t)addr;
+}
+
+int At90sBus::ReadProgByte(long addr)
+{
+	uint8_t cmd[3];
+
+	ProgReadCmd(addr, cmd);
+	SendDataByte(cmd[0]);
+	SendDataByte(cmd[1]);
+	SendDataByte(cmd[2]);
 
 	return RecDataByte();
 }
@@ -735,6 +762,7 @@ long At90sBus::ReadCalibration(int addr)
 long At90sBus::Read(int addr, uint8_t *data, long length, int page_size)
 {
 	long len;
+	bool eep = (addr != 0);
 
 	ReadStart();
 
@@ -744,36 +772,53 @@ long At90sBus::Read(int addr, uint8_t *data, long length, int page_size)
 	//      code[1] = ReadDeviceCode(1);
 	//      code[2] = ReadDeviceCode(2);
 
-	if (addr)
+	//Read page by page, the instructions of a page are streamed
+	// back to back and the progress is updated once per page
+	if (page_size <= 0)
 	{
-		//EEprom
-		addr = 0;
+		page_size = AVR_READ_BURST;
+	}
 
-		for (len = 0; len < length; len++)
-		{
-			*data++ = (uint8_t)ReadEEPByte(addr++);
+	uint8_t *cmd = new uint8_t[3 * page_size];
+
+	addr = 0;
+
+	for (len = 0; len < length; len += page_size)
+	{
+		long n = (length - len < page_size) ? length - len : page_size;
+		long k;
 
-			if (ReadProgress(len * 100 / length))
+		for (k = 0; k < n; k++, addr++)
+		{
+			if (eep)
 			{
-				break;
+				EEPReadCmd(addr, cmd + 3 * k);
+			}
+			else
+			{
+				ProgReadCmd(addr, cmd + 3 * k);
 			}
 		}
-	}
-	else
-	{
-		//Flash Eprom
-		addr = 0;
 
-		for (len = 0; len < length; len++)
+		long rval = ReadBurst(cmd, n, data + len);
+
+		if (rval < 0)
 		{
-			*data++ = (uint8_t)ReadProgByte(addr++);
+			delete[] cmd;
+			return rval;
+		}
 
-			if (ReadProgress(len * 100 / length))
-			{
-				break;
-			}
+		if (ReadProgress(len + n, length))
+		{
+			break;
 		}
+	}
 
+	delete[] cmd;
+
+	if (len > length)
+	{
+		len = length;
 	}
 
 	ReadEnd();
@@ -781,11 +826,38 @@ long At90sBus::Read(int addr, uint8_t *data, long length, int page_size)
 	return len;
 }
 
+//Poll RDY/BSY instruction: bit 0 of the answer is set while busy
+int At90sBus::WaitRdyBsy(int slot, long timeout)
+{
+	PollStart(slot, timeout);
+
+	while (PollWait())
+	{
+		SendDataByte(PollRdyBsy0);
+		SendDataByte(PollRdyBsy1);
+		SendDataByte(0);
+
+		int val = RecDataByte();
+
+		if (val >= 0 && !(val & 1))
+		{
+			PollReady();
+			return OK;
+		}
+	}
+
+	return E2P_TIMEOUT;
+}
+
 int At90sBus::WaitReadyAfterWrite(int type, long addr, int data, long timeout)
 {
 	int rval;
 
-	if (old1200mode)
+	if (enable_rdybsy_polling)
+	{
+		rval = WaitRdyBsy(type ? POLL_WRITE : POLL_PROG, timeout);
+	}
+	else if (old1200mode)
 	{
 		rval = OK;
 		WaitMsec(twd_prog);
@@ -805,14 +877,13 @@ int At90sBus::WaitReadyAfterWrite(int type, long addr, int data, long timeout)
 			{
 				rval = E2P_TIMEOUT;
 
-				int k;
+				PollStart(POLL_WRITE, timeout);
 
-				for (k = 0; k < timeout; k++)
+				while (PollWait())
 				{
-					int val = ReadEEPByte(addr);
-
-					if (val == data)
+					if (ReadEEPByte(addr) == data)
 					{
+						PollReady();
 						rval = OK;
 						break;
 					}
@@ -833,14 +904,13 @@ int At90sBus::WaitReadyAfterWrite(int type, long addr, int data, long timeout)
 			{
 				rval = E2P_TIMEOUT;
 
-				int k;
+				PollStart(POLL_PROG, timeout);
 
-				for (k = 0; k < timeout; k++)
+				while (PollWait())
 				{
-					int val = ReadProgByte(addr);
-
-					if (val == data)
+					if (ReadProgByte(addr) == data)
 					{
+						PollReady();
 						rval = OK;
 						break;
 					}
@@ -863,6 +933,15 @@ int At90sBus::Erase(int type)
 	SendDataByte(0);
 	SendDataByte(0);
 
+	if (enable_rdybsy_polling)
+	{
+		int rval = WaitRdyBsy(POLL_ERASE);
+
+		EraseEnd();
+
+		return rval;
+	}
+
 	WaitMsec(twd_erase);
 	Reset();
 
@@ -891,15 +970,45 @@ long At90sBus::Write(int addr, uint8_t const *data, long length, int page_size)
 
 	WriteStart();
 
-	if (addr)
+	if (addr && page_size > 1 && page_size <= AVR_READ_BURST)
+	{
+		//EEprom page by page
+		for (addr = 0, len = 0; len < length; addr += page_size, data += page_size, len += page_size)
+		{
+			long n = (length - len < page_size) ? length - len : page_size;
+
+			//program only pages that really need to be programmed
+			bool unchanged = IsUnused(data, n) || (HasDeltaImage() ? IsUnchanged(data, n) : CheckEEPPage(addr, data, n));
+
+			if (!unchanged)
+			{
+				if (WriteEEPPage(addr, data, n) != OK)
+				{
+					return E2ERR_WRITEFAILED;
+				}
+			}
+
+			if (WriteProgress(len, length))
+			{
+				break;
+			}
+		}
+
+		if (len > length)
+		{
+			len = length;
+		}
+	}
+	else if (addr)
 	{
 		//EEprom
 		for (addr = 0, len = 0; len < length; addr++, data++, len++)
 		{
 			//09/10/98 -- program only locations that really need to be programmed
-			int val = ReadEEPByte(addr);
+			// (the delta image saves the read back)
+			bool unchanged = IsUnused(data, 1) || (HasDeltaImage() ? IsUnchanged(data, 1) : (ReadEEPByte(addr) == *data));
 
-			if (val != *data)
+			if (!unchanged)
 			{
 				WriteEEPByte(addr, *data);
 
@@ -912,7 +1021,7 @@ long At90sBus::Write(int addr, uint8_t const *data, long length, int page_size)
 				}
 			}
 
-			if (WriteProgress(len * 100 / length))
+			if (WriteProgress(len, length))
 			{
 				break;
 			}
@@ -926,14 +1035,17 @@ long At90sBus::Write(int addr, uint8_t const *data, long length, int page_size)
 			//Flash Eprom with page write
 			for (addr = 0, len = 0; len < length; addr += page_size, data += page_size, len += page_size)
 			{
-				//check for FF's page to skip blank pages
-				if (!CheckBlankPage(data, page_size))
+				//check for FF's page to skip blank pages, or pages equal to the delta image
+				// when the device was not erased
+				bool skip = IsUnused(data, page_size) || (HasDeltaImage() ? IsUnchanged(data, page_size) : CheckBlankPage(data, page_size));
+
+				if (!skip)
 					if (WriteProgPage(addr, data, page_size) != OK)
 					{
 						return E2ERR_WRITEFAILED;
 					}
 
-				if (WriteProgress(len * 100 / length))
+				if (WriteProgress(len, length))
 				{
 					break;
 				}
@@ -944,7 +1056,9 @@ long At90sBus::Write(int addr, uint8_t const *data, long length, int page_size)
 			for (addr = 0, len = 0; len < length; addr++, data++, len++)
 			{
 				//09/10/98 -- program only locations not equal to FF (erase set all FF)
-				if (*data != 0xFF)
+				bool skip = IsUnused(data, 1) || (HasDeltaImage() ? IsUnchanged(data, 1) : (*data == 0xFF));
+
+				if (!skip)
 				{
 					WriteProgByte(addr, *data);
 
@@ -956,7 +1070,7 @@ long At90sBus::Write(int addr, uint8_t const *data, long length, int page_size)
 					}
 				}
 
-				if (WriteProgress(len * 100 / length))
+				if (WriteProgress(len, length))
 				{
 					break;
 				}
@@ -1016,15 +1130,21 @@ int At90sBus::WriteProgPage(long addr, uint8_t const *data, long page_size, long
 
 	SetLastProgrammedAddress(addr + page_size - 1);
 
-	if (enable_flashpage_polling)
+	if (enable_rdybsy_polling)
+	{
+		okflag = (WaitRdyBsy(POLL_PROG, timeout) == OK);
+	}
+	else if (enable_flashpage_polling)
 	{
-		WaitUsec(100);
 		okflag = false;
 
-		for (k = timeout; k > 0; k--)
+		PollStart(POLL_PROG, timeout);
+
+		while (PollWait())
 		{
 			if (ReadProgByte(first_loc) != 0xFF)
 			{
+				PollReady();
 				okflag = true;
 				break;
 			}
@@ -1039,6 +1159,54 @@ int At90sBus::WriteProgPage(long addr, uint8_t const *data, long page_size, long
 	return okflag ? OK : E2P_TIMEOUT;
 }
 
+//True if the EEPROM page at addr already holds data
+bool At90sBus::CheckEEPPage(long addr, uint8_t const *data, long length)
+{
+	uint8_t cmd[3 * AVR_READ_BURST];
+	uint8_t buf[AVR_READ_BURST];
+	long k;
+
+	for (k = 0; k < length; k++)
+	{
+		EEPReadCmd(addr + k, cmd + 3 * k);
+	}
+
+	if (ReadBurst(cmd, length, buf) != length)
+	{
+		return false;
+	}
+
+	return memcmp(buf, data, length) == 0;
+}
+
+//Load the EEPROM page buffer and commit it with a single write cycle
+int At90sBus::WriteEEPPage(long addr, uint8_t const *data, long page_size)
+{
+	long k;
+
+	for (k = 0; k < page_size; k++)
+	{
+		SendDataByte(LoadEEPPage0);
+		SendDataByte(LoadEEPPage1);
+		SendDataByte(k);
+		SendDataByte(data[k]);
+	}
+
+	SendDataByte(WriteEEPPage0);
+	SendDataByte(WriteEEPPage1 | ((addr & 0xFFFF) >> 8));
+	SendDataByte(addr);
+	SendDataByte(0);
+
+	if (enable_rdybsy_polling)
+	{
+		return WaitRdyBsy(POLL_WRITE);
+	}
+
+	WaitMsec(twd_prog);
+
+	return OK;
+}
+
 bool At90sBus::CheckBlankPage(uint8_t const *data, long length)
 {
 	bool blank_page = true;
@@ -29,6 +29,8 @@
 
 #include "spi-bus.h"
 
+#define AVR_READ_BURST          64      //bytes read at once when the device has no page
+
 class At90sBus : public SPIBus
 {
   public:                //------------------------------- public
@@ -50,6 +52,10 @@ class At90sBus : public SPIBus
 
 	void SetFlashPagePolling(bool val);
 	bool GetFlashPagePolling() const;
+	void SetRdyBsyPolling(bool val)
+	{
+		enable_rdybsy_polling = val;
+	}
 	void SetOld1200Mode(bool val)
 	{
 		old1200mode = val;
@@ -67,6 +73,8 @@ class At90sBus : public SPIBus
 	const uint8_t WriteProgPageMem;
 	const uint8_t ReadEEPMem0, ReadEEPMem1;
 	const uint8_t WriteEEPMem0, WriteEEPMem1;
+	const uint8_t LoadEEPPage0, LoadEEPPage1;
+	const uint8_t WriteEEPPage0, WriteEEPPage1;
 	const uint8_t ReadDevCode0, ReadDevCode1;
 	const uint8_t ReadLock0, ReadLock1;
 	const uint8_t WriteLock0, WriteLock1;
@@ -77,6 +85,10 @@ class At90sBus : public SPIBus
 	const uint8_t ReadFuseExt0, ReadFuseExt1;
 	const uint8_t WriteFuseExt0, WriteFuseExt1;
 	const uint8_t ReadCalib0, ReadCalib1;
+	const uint8_t PollRdyBsy0, PollRdyBsy1;
+
+	void EEPReadCmd(long addr, uint8_t *cmd) const;
+	void ProgReadCmd(long addr, uint8_t *cmd) const;
 
 	int ReadEEPByte(long addr);
 	void WriteEEPByte(long addr, int data);
@@ -85,7 +97,10 @@ class At90sBus : public SPIBus
 	int WriteProgPage(long addr, uint8_t const *data, long page_size, long timeout = 10000);
 
 	int WaitReadyAfterWrite(int type, long addr, int data, long timeout = 10000);
+	int WaitRdyBsy(int slot, long timeout = 10000);
 	bool CheckBlankPage(uint8_t const *data, long length);
+	bool CheckEEPPage(long addr, uint8_t const *data, long length);
+	int WriteEEPPage(long addr, uint8_t const *data, long page_size);
 	void RefreshParameters();
 
 	//Polling codes
@@ -101,6 +116,7 @@ class At90sBus : public SPIBus
   private:               //------------------------------- private
 
 	bool enable_flashpage_polling;
+	bool enable_rdybsy_polling;     //device supports the Poll RDY/BSY instruction
 };
 
 #endif
@@ -414,7 +414,21 @@ int At90sxx::Write(int probe, int type)
 	//      if ( (type & PROG_TYPE) && (type & DATA_TYPE) )
 	if ((type & PROG_TYPE))                 //Because to write the flash we must erase ALL the device (a msg may alert that doing so the DATA may be erased too)
 	{
-		GetBus()->Erase();
+		//A delta write can leave the device as it is if the new flash content only clears bits.
+		//A locked device reads back 0xFF or junk and only the erase clears the
+		// lock bits, so the erase is skipped only if no lock bit is programmed.
+		uint32_t lock = 0;
+
+		if (GetBus()->HasDeltaImage() && GetBus()->IsProgrammable(GetBufPtr(), GetSplitted()) &&
+				SecurityRead(lock) == OK && lock == 0)
+		{
+			qDebug() << "At90sxx::Write() delta write without erase";
+		}
+		else
+		{
+			GetBus()->ClearDeltaImage();
+			GetBus()->Erase();
+		}
 	}
 
 	int rv = Probe(probe || GetNoOfBank() == 0);
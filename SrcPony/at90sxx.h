@@ -43,6 +43,12 @@ class At90sxx : public Device
 	int Probe(int probe_size = 0);
 	int Read(int probe = 1, int type = ALL_TYPE);
 	int Write(int probe = 1, int type = ALL_TYPE);
+
+	bool CanDeltaWrite() const
+	{
+		return true;
+	}
+
 	int Verify(int type = ALL_TYPE);
 
 	int Erase(int probe = 1, int type = ALL_TYPE);
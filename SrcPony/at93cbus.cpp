@@ -58,7 +58,8 @@ At93cBus::At93cBus(BusInterface *ptr)
 	  PrClearCode(07),
 	  loop_timeout(8000),
 	  address_len(6),         //9346
-	  organization(ORG16)
+	  organization(ORG16),
+	  sequential_read(true)
 {
 	qDebug() << "At93cBus::At93cBus()";
 }
@@ -149,16 +150,30 @@ long At93cBus::Read(int addr, uint8_t *data, long length, int page_size)
 		inc = 1;
 	}
 
-	//Dal piu` significativo al meno significativo
-	for (len = 0; len < length; len += inc)
+	//Sequential read: a single command, then the address auto increments
+	// while the clock goes on
+	if (sequential_read)
 	{
-		//17/08/98 -- now repeat the command every word
 		clearCS();
 		setCS();
 
-		//Send command opcode
 		SendCmdOpcode(ReadCode);
-		SendAddress(addr++, address_len);
+		SendAddress(addr, address_len);
+	}
+
+	//Dal piu` significativo al meno significativo
+	for (len = 0; len < length; len += inc)
+	{
+		if (!sequential_read)
+		{
+			//17/08/98 -- now repeat the command every word
+			clearCS();
+			setCS();
+
+			//Send command opcode
+			SendCmdOpcode(ReadCode);
+			SendAddress(addr++, address_len);
+		}
 
 		uint16_t val = RecDataWord(organization);
 
@@ -177,12 +192,9 @@ long At93cBus::Read(int addr, uint8_t *data, long length, int page_size)
 			*data++ = (uint8_t)(val & 0xFF);
 		}
 
-		if ((len % 4) == 0)
+		if (ReadProgress(len, length))
 		{
-			if (ReadProgress(len * 100 / length))
-			{
-				break;
-			}
+			break;
 		}
 	}
 
@@ -221,6 +233,8 @@ long At93cBus::Write(int addr, uint8_t const *data, long length, int page_size)
 	for (curaddr = 0; curaddr < length; curaddr++)
 	{
 		uint16_t val;
+		int n = (organization == ORG16) ? 2 : 1;
+		bool unchanged = IsUnused(data, n) || IsUnchanged(data, n);
 
 		if (organization == ORG16)
 		{
@@ -237,26 +251,29 @@ long At93cBus::Write(int addr, uint8_t const *data, long length, int page_size)
 			val = *data++;
 		}
 
-		//Send command opcode
-		SendCmdOpcode(WriteCode);
-		SendAddress(curaddr, address_len);
-		SendDataWord(val, organization);
+		if (!unchanged)
+		{
+			//Send command opcode
+			SendCmdOpcode(WriteCode);
+			SendAddress(curaddr, address_len);
+			SendDataWord(val, organization);
 
 #if 1
 
-		if (WaitReadyAfterWrite(loop_timeout))
-		{
-			return 0;        //- 07/08/99 a number >0 but != length mean "User abort"
-		}
+			if (WaitReadyAfterWrite(loop_timeout))
+			{
+				return 0;        //- 07/08/99 a number >0 but != length mean "User abort"
+			}
 
 #else
-		WaitMsec(10);
+			WaitMsec(10);
 #endif
-		clearCS();
-		setCS();
+			clearCS();
+			setCS();
+		}
 
 		if ((curaddr & 1))
-			if (WriteProgress(curaddr * 100 / length))
+			if (WriteProgress(curaddr, length))
 			{
 				break;
 			}
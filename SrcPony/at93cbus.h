@@ -50,6 +50,16 @@ class At93cBus : public MicroWireBus
 		return organization;
 	}
 
+	//Per word read (a READ command every word) for parts without sequential read
+	void SetSequentialRead(bool val)
+	{
+		sequential_read = val;
+	}
+	bool GetSequentialRead() const
+	{
+		return sequential_read;
+	}
+
 	int Erase(int type = 0);
 
     int CalcAddressSize(int mem_size) const override
@@ -88,6 +98,7 @@ class At93cBus : public MicroWireBus
 
 	int address_len;
 	int organization;
+	bool sequential_read;
 };
 
 #endif
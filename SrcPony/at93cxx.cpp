@@ -139,6 +139,7 @@ int At93cxx::Verify(int type)
 		}
 		else
 		{
+			GetBus()->MaskUnused(GetBufPtr(), localbuf, size);
 			rval = (memcmp(GetBufPtr(), localbuf, size) != 0) ? 0 : 1;
 		}
 	}
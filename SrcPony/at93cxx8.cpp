@@ -147,6 +147,7 @@ int At93cxx8::Verify(int type)
 		}
 		else
 		{
+			GetBus()->MaskUnused(GetBufPtr(), localbuf, size);
 			rval = (memcmp(GetBufPtr(), localbuf, size) != 0) ? 0 : 1;
 		}
 	}
@@ -29,9 +29,17 @@
 
 #include "types.h"
 #include "errcode.h"
+#include "e2profil.h"
+#include "wait.h"
+#include "bustrace.h"
 
 #include <QDebug>
 
+//Waveform step codes for BusInterface::SendWaveform()
+#define WAVE_CLOCK      0x01    //clock line level
+#define WAVE_DATAOUT    0x02    //data out line level
+#define WAVE_SAMPLE     0x10    //sample data in once the lines are set
+#define WAVE_WAIT       0x20    //wait the waveform delay at the end of the step
 
 class BusInterface
 {
@@ -41,6 +49,7 @@ class BusInterface
 		cmd2cmd_delay = 0;
 		installed = -1;
 		old_portno = -1;
+		SetPolarity(0);
 	}
 	//      virtual ~BusInterface();
 
@@ -123,6 +132,80 @@ class BusInterface
 	virtual int IsClockDataUP() = 0;
 	virtual int IsClockDataDOWN() = 0;
 
+	//Play a precomputed waveform of nsteps WAVE_* codes, only changed lines are driven.
+	//When the clock rises data out is set first, otherwise the clock goes first.
+	//A WAVE_WAIT step leaving the clock high waits high_delay, if not negative.
+	//Samples are packed MSb first in samples[], return their number or an error.
+	//The default plays the steps through the single pin functions, interfaces
+	// able to do better override it.
+	virtual int SendWaveform(const uint8_t *wave, int nsteps, int delay, uint8_t *samples, int high_delay = -1)
+	{
+		Wait w;
+		int state = -1;
+		int nsamples = 0;
+
+		for (int k = 0; k < nsteps; k++)
+		{
+			int clk = (wave[k] & WAVE_CLOCK) ? 1 : 0;
+			int dat = (wave[k] & WAVE_DATAOUT) ? 1 : 0;
+			bool clk_chg = (state < 0 || clk != (state & WAVE_CLOCK ? 1 : 0));
+			bool dat_chg = (state < 0 || dat != (state & WAVE_DATAOUT ? 1 : 0));
+
+			if (clk && clk_chg)
+			{
+				if (dat_chg)
+				{
+					SetDataOut(dat);
+				}
+
+				SetClock(1);
+			}
+			else
+			{
+				if (clk_chg)
+				{
+					SetClock(clk);
+				}
+
+				if (dat_chg)
+				{
+					SetDataOut(dat);
+				}
+			}
+
+			state = wave[k] & (WAVE_CLOCK | WAVE_DATAOUT);
+
+			if (wave[k] & WAVE_SAMPLE)
+			{
+				int b = GetDataIn();
+
+				if (b < 0)
+				{
+					return b;
+				}
+
+				if (nsamples % 8 == 0)
+				{
+					samples[nsamples / 8] = 0;
+				}
+
+				if (b)
+				{
+					samples[nsamples / 8] |= 0x80 >> (nsamples % 8);
+				}
+
+				nsamples++;
+			}
+
+			if (wave[k] & WAVE_WAIT)
+			{
+				w.WaitUsec((clk && high_delay >= 0) ? high_delay : delay);
+			}
+		}
+
+		return nsamples;
+	}
+
 	int GetCmd2CmdDelay() const
 	{
 		return cmd2cmd_delay;
@@ -140,7 +223,39 @@ class BusInterface
 		return (installed >= 0) ? true : false;
 	}
 
+	//Line polarity is pushed by e2App when the interface is selected or the
+	// setup changes, so the pin functions never ask the main window
+	void SetPolarity(uint8_t pol)
+	{
+		polarity = pol;
+		inv_ctrl = (pol & RESETINV) ? 1 : 0;
+		inv_clock = (pol & CLOCKINV) ? 1 : 0;
+		inv_datain = (pol & DININV) ? 1 : 0;
+		inv_dataout = (pol & DOUTINV) ? 1 : 0;
+	}
+	uint8_t GetPolarity() const
+	{
+		return polarity;
+	}
+
   protected:             //------------------------------- protected
+	//Line level after the polarity inversion (0 or 1)
+	int CtrlLevel(int v) const
+	{
+		return (v != 0) ^ inv_ctrl;
+	}
+	int ClockLevel(int v) const
+	{
+		return (v != 0) ^ inv_clock;
+	}
+	int DataOutLevel(int v) const
+	{
+		return (v != 0) ^ inv_dataout;
+	}
+	int DataInLevel(int v) const
+	{
+		return (v != 0) ^ inv_datain;
+	}
 	void Install(int val)
 	{
 		installed = val;
@@ -159,6 +274,12 @@ class BusInterface
   private:               //------------------------------- private
 	int             installed;              // -1 --> not installed, >= 0 number if the installed port
 	int             cmd2cmd_delay;  // <> 0 if a delay between commands is needed
+
+	uint8_t         polarity;               // cached polarity_control of e2App
+	int             inv_ctrl;               // 1 if the line is inverted
+	int             inv_clock;
+	int             inv_datain;
+	int             inv_dataout;
 };
 
 #endif
@@ -27,32 +27,128 @@
 #include "busio.h"
 
 #include "e2cmdw.h"
+#include "e2profil.h"
+
+#include <QDebug>
 
 BusIO::BusIO(BusInterface *p)
 	:       err_no(0),
 			last_addr(0),
 			shot_delay(5),
 			busI(p),
-			old_progress(0),
-			last_programmed_addr(0)
+			last_programmed_addr(0),
+			delta_base(0),
+			delta_image(0),
+			delta_len(0),
+			delta_skipped(0),
+			used_base(0),
+			used_map(0),
+			used_len(0),
+			used_page(1),
+			unused_skipped(0),
+			poll_type(0),
+			poll_changed(false),
+			poll_slot(POLL_WRITE),
+			poll_max(0),
+			poll_count(0),
+			poll_interval(POLL_MIN_USEC),
+			poll_t0(0)
+{
+	for (int k = 0; k < POLL_NSLOTS; k++)
+	{
+		poll_est[k] = 0;
+	}
+}
+
+ProgressChannel::ProgressChannel()
+	: status(0),
+	  cur_total(0),
+	  next_done(0),
+	  countdown(0),
+	  t_last(0),
+	  quantum(PROGRESS_QUANTUM),
+	  interval_msec(PROGRESS_INTERVAL_MSEC)
 {
 }
 
-int BusIO::CheckAbort(int progress)
+void ProgressChannel::Start(ProgStatus *st)
 {
-	int abort = cmdWin->GetAbortFlag();
+	status = st;
+
+	//a new operation on the GUI thread, forget the last abort
+	if (!status->IsBusy())
+	{
+		status->ClearAbort();
+	}
+
+	cur_total = 0;
+	Publish(0, 1);
+}
+
+void ProgressChannel::End()
+{
+	if (status)
+	{
+		Publish(1, 1);
+	}
+}
+
+int ProgressChannel::Publish(long done, long total)
+{
+	if (status == 0)
+	{
+		return 0;
+	}
+
+	long long now = Wait::GetTimestamp();
 
-	if (!abort)
+	countdown = PROGRESS_CHECK_CALLS;
+
+	if (total == cur_total && done < next_done &&
+			(now - t_last) / 1000000 < interval_msec)
+	{
+		return IsAborted();
+	}
+
+	if (total <= 0)
 	{
-		if ((progress == 0 /* && old_progress != 0*/) ||
-				progress > old_progress + 4)
+		total = 1;
+	}
+
+	int percent = (done >= total) ? 100 : (int)((long long)done * 100 / total);
+
+	cur_total = total;
+	next_done = done + (long)((long long)total * quantum / 100);
+
+	if (next_done <= done)
+	{
+		next_done = done + 1;
+	}
+
+	t_last = now;
+
+	//on the programming thread only the status block is touched,
+	// the operations still run by the GUI thread pump its events
+	if (status->IsBusy())
+	{
+		status->SetProgress(percent);
+	}
+	else
+	{
+		if (cmdWin->GetAbortFlag())
 		{
-			cmdWin->SetProgress(progress);
-			old_progress = progress;
+			status->SetAbort();
 		}
+
+		cmdWin->SetProgress(percent);
 	}
 
-	return abort;
+	return IsAborted();
+}
+
+void BusIO::StartProgress()
+{
+	progress.Start(cmdWin->GetProgStatus());
 }
 
 int BusIO::Error()
@@ -74,3 +170,237 @@ void BusIO::SetDelay(int delay)
 		shot_delay = delay;
 	}
 }
+
+//True if data is equal to the delta image, so it doesn't need to be written
+bool BusIO::IsUnchanged(uint8_t const *data, long len)
+{
+	if (delta_image == 0 || data < delta_base || data + len > delta_base + delta_len)
+	{
+		return false;
+	}
+
+	if (memcmp(data, delta_image + (data - delta_base), len) != 0)
+	{
+		return false;
+	}
+
+	delta_skipped += len;
+
+	return true;
+}
+
+//True if no location of data was populated, so it doesn't need to be written
+bool BusIO::IsUnused(uint8_t const *data, long len)
+{
+	if (used_map == 0 || len <= 0 || data < used_base || data + len > used_base + used_len)
+	{
+		return false;
+	}
+
+	long last = (data - used_base + len - 1) / used_page;
+
+	for (long k = (data - used_base) / used_page; k <= last; k++)
+	{
+		if (used_map[k])
+		{
+			return false;
+		}
+	}
+
+	unused_skipped += len;
+
+	return true;
+}
+
+//Length of data up to the end of the last populated page
+// (len if there is no map)
+long BusIO::UsedLength(uint8_t const *data, long len) const
+{
+	if (used_map == 0 || len <= 0 || data < used_base || data + len > used_base + used_len)
+	{
+		return len;
+	}
+
+	long first = (data - used_base) / used_page;
+
+	for (long k = (data - used_base + len - 1) / used_page; k >= first; k--)
+	{
+		if (used_map[k])
+		{
+			long end = (k + 1) * used_page - (data - used_base);
+
+			return (end < len) ? end : len;
+		}
+	}
+
+	return 0;
+}
+
+//Copy the locations of data that were not populated over the read back
+// content in localbuf, so the compare ignores them
+void BusIO::MaskUnused(uint8_t const *data, uint8_t *localbuf, long len) const
+{
+	if (used_map == 0 || len <= 0 || data < used_base || data + len > used_base + used_len)
+	{
+		return;
+	}
+
+	long pos = 0;
+
+	while (pos < len)
+	{
+		long k = (data - used_base + pos) / used_page;
+		long n = (k + 1) * used_page - (data - used_base + pos);
+
+		if (n > len - pos)
+		{
+			n = len - pos;
+		}
+
+		if (!used_map[k])
+		{
+			memcpy(localbuf + pos, data + pos, n);
+		}
+
+		pos += n;
+	}
+}
+
+//True if data can be written over the delta image without an erase
+// (it only clears bits)
+bool BusIO::IsProgrammable(uint8_t const *data, long len) const
+{
+	if (delta_image == 0 || data < delta_base || data + len > delta_base + delta_len)
+	{
+		return false;
+	}
+
+	uint8_t const *img = delta_image + (data - delta_base);
+
+	for (long k = 0; k < len; k++)
+	{
+		if (data[k] & ~img[k])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//Load the write cycle times learned for the device type
+void BusIO::SetPollType(long type)
+{
+	if (type == poll_type)
+	{
+		return;
+	}
+
+	SavePollTimes();
+
+	poll_type = type;
+
+	for (int k = 0; k < POLL_NSLOTS; k++)
+	{
+		poll_est[k] = (type != 0) ? E2Profile::GetWriteCycleTime(type, k) : 0;
+	}
+
+	poll_changed = false;
+
+	qDebug() << "BusIO::SetPollType(" << (hex) << type << (dec) << ") write=" << poll_est[POLL_WRITE]
+			 << " prog=" << poll_est[POLL_PROG] << " erase=" << poll_est[POLL_ERASE];
+}
+
+void BusIO::SavePollTimes()
+{
+	if (poll_changed && poll_type != 0)
+	{
+		for (int k = 0; k < POLL_NSLOTS; k++)
+		{
+			E2Profile::SetWriteCycleTime(poll_type, k, poll_est[k]);
+		}
+	}
+
+	poll_changed = false;
+}
+
+void BusIO::PollStart(int slot, long max_polls)
+{
+	if (slot < 0 || slot >= POLL_NSLOTS)
+	{
+		slot = POLL_WRITE;
+	}
+
+	poll_slot = slot;
+	poll_max = max_polls;
+	poll_count = 0;
+	poll_interval = poll_est[slot] / 8;
+
+	if (poll_interval < POLL_MIN_USEC)
+	{
+		poll_interval = POLL_MIN_USEC;
+	}
+	else if (poll_interval > POLL_MAX_USEC)
+	{
+		poll_interval = POLL_MAX_USEC;
+	}
+
+	poll_t0 = GetTimestamp();
+}
+
+bool BusIO::PollWait()
+{
+	if (poll_count == 0)
+	{
+		//skip most of the cycle we already know about
+		if (poll_est[poll_slot] > 0)
+		{
+			WaitUsec(poll_est[poll_slot] * 3 / 4);
+		}
+	}
+	else
+	{
+		if (poll_max > 0 && poll_count >= poll_max)
+		{
+			return false;
+		}
+
+		if (poll_count > 1 && (GetTimestamp() - poll_t0) / 1000000 > POLL_BUDGET_MSEC)
+		{
+			return false;
+		}
+
+		WaitUsec(poll_interval);
+
+		poll_interval *= 2;
+
+		if (poll_interval > POLL_MAX_USEC)
+		{
+			poll_interval = POLL_MAX_USEC;
+		}
+	}
+
+	poll_count++;
+
+	return true;
+}
+
+//The device is ready: update the learned cycle time
+void BusIO::PollReady()
+{
+	long usec = (long)((GetTimestamp() - poll_t0) / 1000);
+	int est = poll_est[poll_slot];
+
+	if (usec <= 0)
+	{
+		usec = 1;
+	}
+
+	est = (est > 0) ? (int)((3L * est + usec) / 4) : (int)usec;
+
+	if (est != poll_est[poll_slot])
+	{
+		poll_est[poll_slot] = est;
+		poll_changed = true;
+	}
+}
@@ -31,6 +31,75 @@
 #include "wait.h"
 #include "businter.h"
 #include "errcode.h"
+#include "progworker.h"
+
+#define PROGRESS_QUANTUM        1       //publish progress every 1% ...
+#define PROGRESS_INTERVAL_MSEC  100     //... or every 100 msec
+#define PROGRESS_CHECK_CALLS    64      //fast path calls between clock checks
+
+//Progress and abort channel of a bus operation. The fast path of Update()
+// is inline: a compare, a countdown and an atomic read of the abort flag.
+//Progress is published to the status block only when it moved by the
+// quantum or the interval elapsed.
+class ProgressChannel
+{
+  public:               //---------------------------------------- public
+
+	ProgressChannel();
+
+	void Start(ProgStatus *st);
+	void End();
+
+	//done out of total units (bytes or words), nonzero to abort
+	int Update(long done, long total)
+	{
+		if (total == cur_total && done < next_done && --countdown > 0)
+		{
+			return IsAborted();
+		}
+
+		return Publish(done, total);
+	}
+
+	bool IsAborted() const
+	{
+		return status && status->IsAborted();
+	}
+
+	void SetQuantum(int percent)
+	{
+		quantum = (percent > 0) ? percent : 1;
+	}
+	void SetInterval(int msec)
+	{
+		interval_msec = (msec > 0) ? msec : 0;
+	}
+
+  private:              //--------------------------------------- private
+
+	int Publish(long done, long total);
+
+	ProgStatus *status;
+	long cur_total;
+	long next_done;         //next value to publish
+	int countdown;          //calls left before the next clock check
+	long long t_last;       //last publish timestamp (nsec)
+	int quantum;            //percent
+	int interval_msec;
+};
+
+//Write cycle polling slots, each one learns its own cycle time
+enum
+{
+	POLL_WRITE = 0,         //byte or page write
+	POLL_PROG,              //program memory byte or page write
+	POLL_ERASE,             //chip erase
+	POLL_NSLOTS
+};
+
+#define POLL_MIN_USEC           50      //first backoff interval
+#define POLL_MAX_USEC           2000    //longest backoff interval
+#define POLL_BUDGET_MSEC        500     //give up polling after this time
 
 //Formato di bus generico seriale
 class BusIO : public Wait
@@ -67,36 +136,41 @@ class BusIO : public Wait
 
 	void ReadStart()
 	{
-		CheckAbort(0);
+		StartProgress();
 	}
 	void ReadEnd()
 	{
-		CheckAbort(100);
+		progress.End();
 	}
-	int ReadProgress(int progress)
+	int ReadProgress(long done, long total)
 	{
-		return CheckAbort(progress);
+		return progress.Update(done, total);
 	}
 
 	void WriteStart()
 	{
-		CheckAbort(0);
+		StartProgress();
 	}
 	void WriteEnd()
 	{
-		CheckAbort(100);
+		progress.End();
 	}
-	int WriteProgress(int progress)
+	int WriteProgress(long done, long total)
 	{
-		return CheckAbort(progress);
+		return progress.Update(done, total);
 	}
 	void EraseStart()
 	{
-		CheckAbort(0);
+		StartProgress();
 	}
 	void EraseEnd()
 	{
-		CheckAbort(100);
+		progress.End();
+	}
+
+	ProgressChannel &GetProgressChannel()
+	{
+		return progress;
 	}
 
 	virtual int ReadDeviceCode(int addr)
@@ -181,6 +255,77 @@ class BusIO : public Wait
 		}
 	}
 
+	//Delta write: image is the content of the device for the buffer
+	// starting at base, Write() skips the locations already equal to it
+	void SetDeltaImage(uint8_t const *base, uint8_t const *image, long len)
+	{
+		delta_base = base;
+		delta_image = image;
+		delta_len = len;
+		delta_skipped = 0;
+	}
+	void ClearDeltaImage()
+	{
+		delta_image = 0;
+	}
+	bool HasDeltaImage() const
+	{
+		return delta_image != 0;
+	}
+	long GetDeltaSkipped() const
+	{
+		return delta_skipped;
+	}
+
+	//Sparse write: map has an entry every page bytes of the buffer starting
+	// at base, zero for the pages no file record populated. Write() skips
+	// them and Verify() doesn't compare them.
+	void SetUsedMap(uint8_t const *base, uint8_t const *map, long len, int page)
+	{
+		used_base = base;
+		used_map = map;
+		used_len = len;
+		used_page = (page > 0) ? page : 1;
+		unused_skipped = 0;
+	}
+	void ClearUsedMap()
+	{
+		used_map = 0;
+	}
+	bool HasUsedMap() const
+	{
+		return used_map != 0;
+	}
+	long GetUnusedSkipped() const
+	{
+		return unused_skipped;
+	}
+
+	bool IsUnchanged(uint8_t const *data, long len);
+	bool IsUnused(uint8_t const *data, long len);
+	long UsedLength(uint8_t const *data, long len) const;
+	void MaskUnused(uint8_t const *data, uint8_t *localbuf, long len) const;
+	bool IsProgrammable(uint8_t const *data, long len) const;
+
+	//Write cycle polling scheduler: PollStart(), then PollWait() before
+	// every poll of the device until it's ready and PollReady() once it is.
+	//The first poll is delayed by the learned cycle time, the next ones
+	// back off exponentially. PollWait() returns false when max_polls or
+	// the time budget are over.
+	void SetPollType(long type);
+	void SavePollTimes();
+	void PollStart(int slot, long max_polls = 0);
+	bool PollWait();
+	void PollReady();
+	long GetPollType() const        //device type set by SetPollType()
+	{
+		return poll_type;
+	}
+	int GetPollTime(int slot) const
+	{
+		return (slot >= 0 && slot < POLL_NSLOTS) ? poll_est[slot] : 0;
+	}
+
   protected:             //------------------------------- protected
 
 	int     err_no;                 //error code
@@ -192,11 +337,31 @@ class BusIO : public Wait
 
   private:               //------------------------------- private
 
-	int CheckAbort(int progress = 0);
+	void StartProgress();
 
-	int old_progress;
+	ProgressChannel progress;
 	long last_programmed_addr;      //record last programmed address for verify
 
+	uint8_t const *delta_base;
+	uint8_t const *delta_image;
+	long delta_len;
+	long delta_skipped;             //bytes not written by the delta write
+
+	uint8_t const *used_base;
+	uint8_t const *used_map;
+	long used_len;
+	int used_page;
+	long unused_skipped;            //bytes not written by the sparse write
+
+	long poll_type;                 //device type the learned times belong to
+	int poll_est[POLL_NSLOTS];      //learned write cycle times (usec)
+	bool poll_changed;
+	int poll_slot;
+	long poll_max;
+	long poll_count;
+	long poll_interval;
+	long long poll_t0;
+
 };
 
 #endif
@@ -0,0 +1,126 @@
+//=========================================================================//
+//                                                                         //
+//  PonyProg - Serial Device Programmer                                    //
+//                                                                         //
+//  Copyright (C) 1997-2017   Claudio Lanconelli                           //
+//                                                                         //
+//  http://ponyprog.sourceforge.net                                        //
+//                                                                         //
+//-------------------------------------------------------------------------//
+//                                                                         //
+// This program is free software; you can redistribute it and/or           //
+// modify it under the terms of the GNU  General Public License            //
+// as published by the Free Software Foundation; either version2 of        //
+// the License, or (at your option) any later version.                     //
+//                                                                         //
+// This program is distributed in the hope that it will be useful,         //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of          //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       //
+// General Public License for more details.                                //
+//                                                                         //
+// You should have received a copy of the GNU  General Public License      //
+// along with this program (see LICENSE);     if not, write to the         //
+// Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA. //
+//                                                                         //
+//=========================================================================//
+
+#include "bustrace.h"
+
+#ifdef  ENABLE_BUSTRACE
+
+#include "errcode.h"
+
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+
+BusTraceRec BusTrace::ring[BUSTRACE_SIZE];
+std::atomic<unsigned int> BusTrace::head(0);
+
+//VCD identifiers of the traced signals, indexed by BusTracePin
+static const char *vcd_id[] = { "%", "!", "\"", "#", "$" };
+static const char *vcd_name[] = { "op", "ctrl", "clock", "dataout", "datain" };
+
+void BusTrace::Clear()
+{
+	head.store(0);
+}
+
+QString BusTrace::GetDefaultFile()
+{
+	return QDir::tempPath() + "/ponyprog-trace.vcd";
+}
+
+int BusTrace::DumpVCD(const QString &fname)
+{
+	QFile fh(fname);
+
+	if (!fh.open(QIODevice::WriteOnly | QIODevice::Text))
+	{
+		return CREATEERROR;
+	}
+
+	QTextStream out(&fh);
+	unsigned int end = head.load();
+	unsigned int count = (end < BUSTRACE_SIZE) ? end : BUSTRACE_SIZE;
+	unsigned int k;
+	int j;
+
+	out << "$version PonyProg bus trace $end\n";
+	out << "$timescale 1ns $end\n";
+	out << "$scope module bus $end\n";
+	out << "$var wire 8 " << vcd_id[0] << " " << vcd_name[0] << " $end\n";
+
+	for (j = TRACE_CTRL; j <= TRACE_DATAIN; j++)
+	{
+		out << "$var wire 1 " << vcd_id[j] << " " << vcd_name[j] << " $end\n";
+	}
+
+	out << "$upscope $end\n";
+	out << "$enddefinitions $end\n";
+	out << "$dumpvars\nb0 " << vcd_id[0] << "\n";
+
+	for (j = TRACE_CTRL; j <= TRACE_DATAIN; j++)
+	{
+		out << "x" << vcd_id[j] << "\n";
+	}
+
+	out << "$end\n";
+
+	long long t0 = 0, last = 0;
+
+	for (k = end - count; k != end; k++)
+	{
+		const BusTraceRec &r = ring[k & (BUSTRACE_SIZE - 1)];
+
+		if (k == end - count)
+		{
+			t0 = r.ts;
+		}
+
+		//records of concurrent writers may be slightly out of order
+		long long t = (r.ts - t0 > last) ? r.ts - t0 : last;
+
+		if (t != last || k == end - count)
+		{
+			out << "#" << t << "\n";
+		}
+
+		out << "b" << QString::number(r.op, 2) << " " << vcd_id[0] << "\n";
+
+		if (r.pin != TRACE_NOPIN && r.pin <= TRACE_DATAIN)
+		{
+			out << (int)r.value << vcd_id[r.pin] << "\n";
+		}
+
+		last = t;
+	}
+
+	fh.close();
+
+	qDebug() << "BusTrace::DumpVCD(" << fname << ")" << count << "records";
+
+	return OK;
+}
+
+#endif
@@ -0,0 +1,111 @@
+//=========================================================================//
+//                                                                         //
+//  PonyProg - Serial Device Programmer                                    //
+//                                                                         //
+//  Copyright (C) 1997-2017   Claudio Lanconelli                           //
+//                                                                         //
+//  http://ponyprog.sourceforge.net                                        //
+//                                                                         //
+//-------------------------------------------------------------------------//
+//                                                                         //
+// This program is free software; you can redistribute it and/or           //
+// modify it under the terms of the GNU  General Public License            //
+// as published by the Free Software Foundation; either version2 of        //
+// the License, or (at your option) any later version.                     //
+//                                                                         //
+// This program is distributed in the hope that it will be useful,         //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of          //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       //
+// General Public License for more details.                                //
+//                                                                         //
+// You should have received a copy of the GNU  General Public License      //
+// along with this program (see LICENSE);     if not, write to the         //
+// Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA. //
+//                                                                         //
+//=========================================================================//
+
+#ifndef _BUSTRACE_H
+#define _BUSTRACE_H
+
+#include "types.h"
+
+#include <QDebug>
+#include <QString>
+
+//Debug lines printed on every pin transition cost more than the transition
+// itself, they are compiled out unless ENABLE_EDGE_DEBUG is defined
+#ifdef  ENABLE_EDGE_DEBUG
+#define qDebugEdge()            qDebug()
+#else
+#define qDebugEdge()            while (false) qDebug()
+#endif
+
+enum BusTracePin
+{
+	TRACE_NOPIN = 0,
+	TRACE_CTRL,
+	TRACE_CLOCK,
+	TRACE_DATAOUT,
+	TRACE_DATAIN
+};
+
+enum BusTraceOp
+{
+	TRACE_SET = 1,          //pin driven
+	TRACE_GET,              //pin sampled
+	TRACE_OPEN,             //interface opened
+	TRACE_CLOSE             //interface closed
+};
+
+#ifdef  ENABLE_BUSTRACE
+
+#include <atomic>
+
+#include "wait.h"
+
+#define BUSTRACE_SIZE           (1 << 16)       //records, must be a power of 2
+
+struct BusTraceRec
+{
+	long long ts;           //Wait::GetTimestamp() nsec
+	uint8_t pin;
+	uint8_t value;
+	uint8_t op;
+};
+
+//Fixed size ring of the last BUSTRACE_SIZE pin events. Writers only reserve
+// a slot with an atomic increment, old records are overwritten.
+class BusTrace
+{
+  public:
+	static void Record(int pin, int value, int op)
+	{
+		BusTraceRec &r = ring[head.fetch_add(1, std::memory_order_relaxed) & (BUSTRACE_SIZE - 1)];
+
+		r.ts = Wait::GetTimestamp();
+		r.pin = pin;
+		r.value = value ? 1 : 0;
+		r.op = op;
+	}
+
+	static void Clear();
+
+	//Write the ring in Value Change Dump format (GTKWave, PulseView, ...)
+	static int DumpVCD(const QString &fname);
+
+	static QString GetDefaultFile();
+
+  private:
+	static BusTraceRec ring[BUSTRACE_SIZE];
+	static std::atomic<unsigned int> head;
+};
+
+#define BUSTRACE(pin, val, op)  BusTrace::Record(pin, val, op)
+
+#else
+
+#define BUSTRACE(pin, val, op)  ((void)0)
+
+#endif
+
+#endif
@@ -242,6 +242,27 @@ int Device::VerifyProg(unsigned char *localbuf)
 		GetBus()->ClearLastProgrammedAddress(); //reset last_programmed_addr, so next verify not preceeded by write verify all the flash
 	}
 
+	//Sparse image: don't read beyond the last populated page
+	if (GetBus()->HasUsedMap())
+	{
+		v_len = GetBus()->UsedLength(GetBufPtr(), v_len);
+
+		if (read_progpage_size && (v_len % read_progpage_size) != 0)
+		{
+			v_len += read_progpage_size - v_len % read_progpage_size;
+
+			if (v_len > size)
+			{
+				v_len = size;
+			}
+		}
+
+		if (v_len == 0)
+		{
+			return OK;
+		}
+	}
+
 	//Set blank locations to default 0xFF (erased)
 	memset(localbuf, 0xFF, size);
 
@@ -264,6 +285,7 @@ int Device::VerifyProg(unsigned char *localbuf)
 	}
 	else
 	{
+		GetBus()->MaskUnused(GetBufPtr() + base, localbuf + base, v_len);
 		rval = GetBus()->CompareMultiWord(GetBufPtr() + base, localbuf + base, v_len, 0) == 0 ? OK : 1;
 	}
 
@@ -276,6 +298,26 @@ int Device::VerifyData(unsigned char *localbuf)
 	int size = GetSize() - GetSplitted();
 	int base = GetSplitted();
 
+	if (GetBus()->HasUsedMap())
+	{
+		size = GetBus()->UsedLength(GetBufPtr() + base, size);
+
+		if (read_datapage_size > 1 && (size % read_datapage_size) != 0)
+		{
+			size += read_datapage_size - size % read_datapage_size;
+
+			if (size > GetSize() - base)
+			{
+				size = GetSize() - base;
+			}
+		}
+
+		if (size == 0)
+		{
+			return OK;
+		}
+	}
+
 	//read current EEPROM content and
 	rval = GetBus()->Read(1, localbuf + base, size, read_datapage_size);
 
@@ -288,6 +330,7 @@ int Device::VerifyData(unsigned char *localbuf)
 	}
 	else
 	{
+		GetBus()->MaskUnused(GetBufPtr() + base, localbuf + base, size);
 		rval = GetBus()->CompareMultiWord(GetBufPtr() + base, localbuf + base, size, 1) == 0 ? OK : 1;
 	}
 
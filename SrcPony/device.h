@@ -58,6 +58,12 @@ class Device
 		return GetBus()->Erase();
 	}
 
+	//True if Write() honours the delta image of the bus (BusIO::SetDeltaImage)
+	virtual bool CanDeltaWrite() const
+	{
+		return false;
+	}
+
 	virtual int BankRollOverDetect(int force)
 	{
 		(void)force;
@@ -82,10 +82,7 @@ void Dt006Interface::SetControlLine(int res)
 {
 	if (IsInstalled())
 	{
-		if (cmdWin->GetPolarity() & RESETINV)
-		{
-			res = !res;
-		}
+		res = CtrlLevel(res);
 
 		OutDataMask(WF_RST, res ? 0 : 1);
 	}
@@ -144,10 +141,7 @@ void Dt006Interface::SetDataOut(int sda)
 {
 	if (IsInstalled())
 	{
-		if (cmdWin->GetPolarity() & DOUTINV)
-		{
-			sda = !sda;
-		}
+		sda = DataOutLevel(sda);
 
 		OutDataMask(WF_DOUT, sda ? 1 : 0);
 	}
@@ -157,10 +151,7 @@ void Dt006Interface::SetClock(int scl)
 {
 	if (IsInstalled())
 	{
-		if (cmdWin->GetPolarity() & CLOCKINV)
-		{
-			scl = !scl;
-		}
+		scl = ClockLevel(scl);
 
 		OutDataMask(WF_SCK, scl ? 1 : 0);
 	}
@@ -170,25 +161,24 @@ void Dt006Interface::SetClockData()
 {
 	if (IsInstalled())
 	{
-		int control     = cmdWin->GetPolarity();
 		uint8_t cpreg = GetLastData();
 
-		if (control & CLOCKINV)
+		if (ClockLevel(1))
 		{
-			cpreg &= ~WF_SCK;
+			cpreg |= WF_SCK;
 		}
 		else
 		{
-			cpreg |= WF_SCK;
+			cpreg &= ~WF_SCK;
 		}
 
-		if (control & DOUTINV)
+		if (DataOutLevel(1))
 		{
-			cpreg &= ~WF_DOUT;
+			cpreg |= WF_DOUT;
 		}
 		else
 		{
-			cpreg |= WF_DOUT;
+			cpreg &= ~WF_DOUT;
 		}
 
 		OutDataPort(cpreg);
@@ -200,10 +190,9 @@ void Dt006Interface::ClearClockData()
 {
 	if (IsInstalled())
 	{
-		int control = cmdWin->GetPolarity();
 		uint8_t cpreg = GetLastData();
 
-		if (control & CLOCKINV)
+		if (ClockLevel(0))
 		{
 			cpreg |= WF_SCK;
 		}
@@ -212,7 +201,7 @@ void Dt006Interface::ClearClockData()
 			cpreg &= ~WF_SCK;
 		}
 
-		if (control & DOUTINV)
+		if (DataOutLevel(0))
 		{
 			cpreg |= WF_DOUT;
 		}
@@ -229,14 +218,8 @@ int Dt006Interface::GetDataIn()
 {
 	if (IsInstalled())
 	{
-		if (cmdWin->GetPolarity() & DININV)
-		{
-			return InDataPort() & RF_DIN;
-		}
-		else
-		{
-			return !(InDataPort() & RF_DIN);
-		}
+		//the DT006 data input is inverting
+		return !DataInLevel(InDataPort() & RF_DIN);
 	}
 	else
 	{
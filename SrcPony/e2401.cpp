@@ -100,7 +100,7 @@ int mE2401::Read(int probe, int type)
 					return GetBus()->Error();
 				}
 
-				if (GetBus()->ReadProgress((k + 1) * 100 / size))
+				if (GetBus()->ReadProgress(k + 1, size))
 				{
 					return OP_ABORTED;
 				}
@@ -147,7 +147,7 @@ int mE2401::Write(int probe, int type)
 				return E2P_TIMEOUT;
 			}
 
-			if (GetBus()->WriteProgress((j + 1) * 100 / size))
+			if (GetBus()->WriteProgress(j + 1, size))
 			{
 				return OP_ABORTED;
 			}
@@ -191,7 +191,7 @@ int mE2401::Verify(int type)
 					break;
 				}
 
-				if (GetBus()->ReadProgress((k + 1) * 100 / size))
+				if (GetBus()->ReadProgress(k + 1, size))
 				{
 					rval = OP_ABORTED;
 					break;
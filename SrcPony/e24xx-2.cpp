@@ -48,6 +48,8 @@ E24xx2::E24xx2(e2AppWinInfo *wininfo, BusIO *busp)
 	E2Profile::SetI2CPageWrite(writepage_size);
 }
 
+#define MAX_BANK_SIZE   0x10000         //2 bytes word address
+
 int E24xx2::Probe(int probe_size)
 {
 	int rval = E24xx::Probe(probe_size);
@@ -55,8 +57,17 @@ int E24xx2::Probe(int probe_size)
 	if (rval > 0)
 	{
 		long size = GetSize();
+		int k;
+
+		//Bigger than 64KB (24M01, 24M02): the higher address bits
+		// go in the slave address
+		n_bank = (size > MAX_BANK_SIZE) ? size / MAX_BANK_SIZE : 1;
+
+		for (k = 1; k < n_bank; k++)
+		{
+			eeprom_addr[k] = eeprom_addr[0] + 2 * k;
+		}
 
-		n_bank = 1;
 		SetBankSize(size / n_bank);
 		SetNoOfBank(n_bank);
 	}
@@ -81,39 +92,38 @@ int E24xx2::Write(int probe, int type)
 	GetBus()->WriteStart();
 
 	long size = GetSize();
-	unsigned char *localbuf = new unsigned char[writepage_size + 2];
+	long bank_size = GetBankSize();
+	int page_size = GetWritePageSize();
 
 	int rval = OK;
 
-	if (type & PROG_TYPE)
+	if (page_size <= 0 || page_size > I2C_MAX_PAGE)
+	{
+		rval = BADPARAM;
+	}
+	else if (type & PROG_TYPE)
 	{
 		long j;
 
-		for (j = 0; j < size; j += writepage_size)
+		for (j = 0; j < size; j += page_size)
 		{
-			memcpy(localbuf + 2, GetBufPtr() + j, writepage_size);
-
-			localbuf[0] = (uint8_t)((j >> 8) & 0xFF);
-			localbuf[1] = (uint8_t)(j & 0xFF);
-
-			if (GetBus()->Write(eeprom_addr[0], localbuf, 2 + writepage_size) != (2 + writepage_size))
-			{
-				rval = GetBus()->Error();
-				break;
-			}
-
-			int k;
-
-			for (k = timeout_loop; k > 0 && GetBus()->Read(eeprom_addr[0], localbuf, 1) != 1; k--)
-				;
-
-			if (k == 0)
+			if (!GetBus()->IsUnused(GetBufPtr() + j, page_size) && !GetBus()->IsUnchanged(GetBufPtr() + j, page_size))
 			{
-				rval = E2P_TIMEOUT;
-				break;
+				int addr = eeprom_addr[j / bank_size];
+
+				if (GetBus()->WriteBlock(addr, j % bank_size, 2, GetBufPtr() + j, page_size) != page_size)
+				{
+					rval = GetBus()->Error();
+					break;
+				}
+
+				if ((rval = WaitWriteCycle(addr)) != OK)
+				{
+					break;
+				}
 			}
 
-			if (GetBus()->WriteProgress(j * 100 / size))
+			if (GetBus()->WriteProgress(j, size))
 			{
 				rval = OP_ABORTED;
 				break;
@@ -123,8 +133,6 @@ int E24xx2::Write(int probe, int type)
 
 	GetBus()->WriteEnd();
 
-	delete[] localbuf;
-
 	if (rval == OK)
 	{
 		return GetSize();
@@ -135,6 +143,33 @@ int E24xx2::Write(int probe, int type)
 	}
 }
 
+#define READ_CHUNK      256             //bytes per sequential read transaction
+
+//Read bank k in READ_CHUNK sequential transactions, the progress is
+// updated (and abort checked) between them
+int E24xx2::ReadBank(int k, uint8_t *data, long done, long total)
+{
+	long bank_size = GetBankSize();
+	long j;
+
+	for (j = 0; j < bank_size; j += READ_CHUNK)
+	{
+		long n = (bank_size - j < READ_CHUNK) ? bank_size - j : READ_CHUNK;
+
+		if (GetBus()->ReadBlock(eeprom_addr[k], j, 2, data + j, n) < n)
+		{
+			return GetBus()->Error();
+		}
+
+		if (GetBus()->ReadProgress(done + j + n, total))
+		{
+			return OP_ABORTED;
+		}
+	}
+
+	return OK;
+}
+
 int E24xx2::Read(int probe, int type)
 {
 	int error = Probe(probe || GetNoOfBank() == 0);
@@ -150,33 +185,13 @@ int E24xx2::Read(int probe, int type)
 
 	if (type & PROG_TYPE)
 	{
-		uint8_t index[2];
-		long readpage_size = 256;
-		long k;
-		long size = GetSize();
+		long bank_size = GetBankSize();
+		int k;
 
-		for (k = 0; k < size; k += readpage_size)
+		for (k = 0; k < n_bank; k++)
 		{
-			//Scrive l'indice del sottoindirizzamento
-			// partiamo sempre da 0.
-			index[0] = (uint8_t)((k >> 8) & 0xFF);
-			index[1] = (uint8_t)(k & 0xFF);
-
-			if (GetBus()->StartWrite(eeprom_addr[0], index, 2) != 2)
+			if ((error = ReadBank(k, GetBufPtr() + k * bank_size, k * bank_size, n_bank * bank_size)) != OK)
 			{
-				error = GetBus()->Error();
-				break;
-			}
-
-			if (GetBus()->Read(eeprom_addr[0], GetBufPtr() + k, readpage_size) < readpage_size)
-			{
-				error = GetBus()->Error();
-				break;
-			}
-
-			if (GetBus()->ReadProgress(k * 100 / size))
-			{
-				error = OP_ABORTED;
 				break;
 			}
 		}
@@ -203,8 +218,13 @@ int E24xx2::Verify(int type)
 		return rval;
 	}
 
-	long readpage_size = 256;
-	unsigned char *localbuf = new unsigned char[readpage_size];
+	if (n_bank == 0)
+	{
+		return BADPARAM;
+	}
+
+	long bank_size = GetBankSize();
+	unsigned char *localbuf = new unsigned char[bank_size];
 
 	GetBus()->ReadStart();
 
@@ -212,38 +232,29 @@ int E24xx2::Verify(int type)
 
 	if (type & PROG_TYPE)
 	{
-		uint8_t index[2];
-		long k;
-		long size = GetSize();
+		int k;
 
-		for (k = 0; k < size; k += readpage_size)
+		for (k = 0; k < n_bank; k++)
 		{
-			//Scrive l'indice del sottoindirizzamento
-			// partiamo sempre da 0.
-			index[0] = (uint8_t)((k >> 8) & 0xFF);
-			index[1] = (uint8_t)(k & 0xFF);
-
-			if (GetBus()->StartWrite(eeprom_addr[0], index, 2) != 2)
+			//skip the banks the loaded file didn't populate
+			if (GetBus()->UsedLength(GetBufPtr() + k * bank_size, bank_size) == 0)
 			{
-				rval = GetBus()->Error();
-				break;
+				continue;
 			}
 
-			if (GetBus()->Read(eeprom_addr[0], localbuf, readpage_size) < readpage_size)
-			{
-				rval = GetBus()->Error();
-				break;
-			}
+			int error = ReadBank(k, localbuf, k * bank_size, n_bank * bank_size);
 
-			if (memcmp(GetBufPtr() + k, localbuf, readpage_size) != 0)
+			if (error != OK)
 			{
-				rval = 0;
+				rval = error;
 				break;
 			}
 
-			if (GetBus()->ReadProgress(k * 100 / size))
+			GetBus()->MaskUnused(GetBufPtr() + k * bank_size, localbuf, bank_size);
+
+			if (memcmp(GetBufPtr() + k * bank_size, localbuf, bank_size) != 0)
 			{
-				rval = OP_ABORTED;
+				rval = 0;
 				break;
 			}
 		}
@@ -51,8 +51,15 @@ class E24xx2 : public E24xx
 
   protected:    //--------------------------------------- protected
 
+	int GetAddrBytes() const
+	{
+		return 2;
+	}
+
   private:              //--------------------------------------- private
 
+	int ReadBank(int k, uint8_t *data, long done, long total);
+
 	int const SecurityReadCode;
 	int const SecurityWriteCode;
 	int const HEnduranceReadCode;
@@ -84,14 +84,11 @@ int E24xx5::Write(int probe, int type)
 		}
 
 		//Ack polling
-		int k;
+		int rval = WaitWriteCycle(eeprom_addr[0]);
 
-		for (k = timeout_loop; k > 0 && GetBus()->Read(eeprom_addr[0], buffer, 1) != 1; k--)
-			;
-
-		if (k == 0)
+		if (rval != OK)
 		{
-			return E2P_TIMEOUT;
+			return rval;
 		}
 	}
 
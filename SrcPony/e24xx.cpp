@@ -69,28 +69,37 @@ E24xx::~E24xx()
 int E24xx::Probe(int probe_size)
 {
 	int addr, error, k;
-	uint8_t ch;
 
 	qDebug() << "E24xx::Probe(" << probe_size << ") - IN";
 
+	//only the bank addresses are probed, each once per bus session
+	// unless the size is probed
+	if (probe_size)
+	{
+		GetBus()->ForgetScan();
+	}
+
 	n_bank = 0;
 
 	for (addr = base_addr, k = 0; k < max_bank; k++, addr += 2)
 	{
-		if (GetBus()->Read(addr, &ch, 1) != 1)
+		if ((error = GetBus()->IsPresent(addr)) < 0)
 		{
-			if ((error = GetBus()->Error()) != IICERR_NOADDRACK)
-			{
-				//      GetBus()->Open(E2Profile::GetPort());
-				return error;
-			}
+			return error;
 		}
-		else
+
+		if (error)
 		{
 			eeprom_addr[n_bank++] = addr;
 		}
 	}
 
+	//adaptive speed: measure this device type the first time it's found
+	if (n_bank > 0 && GetAddrBytes() > 0 && GetBus()->NeedCalibration())
+	{
+		GetBus()->Calibration(eeprom_addr[0], GetAddrBytes());
+	}
+
 	if (probe_size)
 	{
 		SetNoOfBank(n_bank);
@@ -130,7 +139,7 @@ int E24xx::Read(int probe, int type)
 				return error;
 			}
 
-			if (GetBus()->ReadProgress((k + 1) * 100 / n_bank))
+			if (GetBus()->ReadProgress((k + 1) * GetBankSize(), n_bank * GetBankSize()))
 			{
 				return OP_ABORTED;
 			}
@@ -173,7 +182,7 @@ int E24xx::Write(int probe, int type)
 				return error;
 			}
 
-			if (GetBus()->WriteProgress((k + 1) * 100 / GetNoOfBank()))
+			if (GetBus()->WriteProgress((k + 1) * GetBankSize(), GetNoOfBank() * GetBankSize()))
 			{
 				return OP_ABORTED;
 			}
@@ -209,6 +218,12 @@ int E24xx::Verify(int type)
 		{
 			int error;
 
+			//skip the banks the loaded file didn't populate
+			if (GetBus()->UsedLength(GetBufPtr() + k * GetBankSize(), GetBankSize()) == 0)
+			{
+				continue;
+			}
+
 			if ((error = bank_in(localbuf, k)))
 			{
 				//      GetBus()->Open(E2Profile::GetPort());
@@ -216,13 +231,15 @@ int E24xx::Verify(int type)
 				break;
 			}
 
+			GetBus()->MaskUnused(GetBufPtr() + k * GetBankSize(), localbuf, GetBankSize());
+
 			if (memcmp(GetBufPtr() + k * GetBankSize(), localbuf, GetBankSize()) != 0)
 			{
 				rval = 0;
 				break;
 			}
 
-			if (GetBus()->ReadProgress((k + 1) * 100 / GetNoOfBank()))
+			if (GetBus()->ReadProgress((k + 1) * GetBankSize(), GetNoOfBank() * GetBankSize()))
 			{
 				rval = OP_ABORTED;
 				break;
@@ -235,77 +252,94 @@ int E24xx::Verify(int type)
 	return rval;
 }
 
-#define MAX_BANK_SIZE	256
+//Page size from the device table, writepage_size if it has none.
+//An explicit I2CPageWriteLimit setting caps it, for same-named parts
+// with smaller pages.
+int E24xx::GetWritePageSize() const
+{
+	int page_size = GetProgPageSize(false);
+
+	if (page_size <= 0)
+	{
+		return writepage_size;
+	}
+
+	int user_size = E2Profile::GetI2CPageWriteLimit();
+
+	if (user_size > 1 && user_size < page_size)
+	{
+		page_size = user_size;
+	}
+
+	return page_size;
+}
+
+#define MAX_BANK_SIZE	256             //1 byte word address
 
-// questa routine si aspetta che in ingresso i 256 bytes da programmare l'eeprom
-// siano memorizzati nel iicbuffer nelle locazioni da 1 (non da 0!) a 256
+//Write size bytes of the bank starting at word address idx, a page at a time
 int E24xx::bank_out(uint8_t const *copy_buf, int bank, long size, long idx)
 {
-	int k, j;
-	uint8_t buffer[MAX_BANK_SIZE + 1];
+	long j;
+	int rval;
+	int page_size = GetWritePageSize();
 
 	if (size <= 0)
 	{
 		size = GetBankSize();
 	}
 
-	qDebug() << "E24xx::bank_out() = bank " << bank << ", size = " << size << ", idx = " << idx;
+	qDebug() << "E24xx::bank_out() = bank " << bank << ", size = " << size << ", idx = " << idx << ", page = " << page_size;
 
-	if (copy_buf == 0 || bank >= GetNoOfBank() || size > MAX_BANK_SIZE)
+	if (copy_buf == 0 || bank >= GetNoOfBank() || idx + size > MAX_BANK_SIZE || page_size > I2C_MAX_PAGE)
 	{
 		return BADPARAM;
 	}
 
-	memcpy(buffer + 1, copy_buf, size);
-#if 0
-
-	for (j = 0; j < size; j++)
+	for (j = 0; j < size; j += page_size)
 	{
-		buffer[j] = j;
+		long n = (size - j < page_size) ? size - j : page_size;
 
-		if (GetBus()->Write(eeprom_addr[bank], buffer + j, 2) != 2)
+		if (GetBus()->IsUnused(copy_buf + j, n) || GetBus()->IsUnchanged(copy_buf + j, n))
 		{
-			return GetBus()->Error();
+			continue;
 		}
 
-		for (k = timeout_loop; k > 0 && GetBus()->Read(eeprom_addr[bank], buffer, 1) != 1; k--)
-			;
+		if (GetBus()->WriteBlock(eeprom_addr[bank], idx + j, 1, copy_buf + j, n) != n)
+		{
+			return GetBus()->Error();
+		}
 
-		if (k == 0)
+		if ((rval = WaitWriteCycle(eeprom_addr[bank])) != OK)
 		{
-			return E2P_TIMEOUT;
+			return rval;
 		}
 	}
 
-#else
-
-	for (j = 0; j < size; j += writepage_size)
-	{
-		buffer[j] = j;
+	return OK;
+}
 
-		if (GetBus()->Write(eeprom_addr[bank], buffer + j, 1 + writepage_size) != (1 + writepage_size))
-		{
-			return GetBus()->Error();
-		}
+//Ack polling: the device doesn't acknowledge its address until the
+// write cycle is over
+int E24xx::WaitWriteCycle(int addr)
+{
+	uint8_t ch;
 
-		for (k = timeout_loop; k > 0 && GetBus()->Read(eeprom_addr[bank], buffer, 1) != 1; k--)
-			;
+	GetBus()->PollStart(POLL_WRITE, timeout_loop);
 
-		if (k == 0)
+	while (GetBus()->PollWait())
+	{
+		if (GetBus()->Read(addr, &ch, 1) == 1)
 		{
-			return E2P_TIMEOUT;
+			GetBus()->PollReady();
+			return OK;
 		}
 	}
 
-#endif
-
-	return OK;
+	return E2P_TIMEOUT;
 }
 
 int E24xx::bank_in(uint8_t *copy_buf, int bank, long size, long idx)
 {
-	uint8_t ch;
-
 	if (copy_buf == 0)   // || bank >= GetNoOfBank())
 	{
 		return BADPARAM;
@@ -316,34 +350,20 @@ int E24xx::bank_in(uint8_t *copy_buf, int bank, long size, long idx)
 		size = GetBankSize();
 	}
 
-	ch = (uint8_t)idx;
-
-	if (GetBus()->StartWrite(eeprom_addr[bank], &ch, 1) != 1)
-	{
-		return GetBus()->Error();
-	}
-
 	if (sequential_read)
 	{
-		if (GetBus()->Read(eeprom_addr[bank], copy_buf, size) < size)
+		if (GetBus()->ReadBlock(eeprom_addr[bank], idx, 1, copy_buf, size) < size)
 		{
 			return GetBus()->Error();
 		}
 	}
 	else
 	{
-		int k;
+		long k;
 
 		for (k = 0; k < size; k++)
 		{
-			ch = (uint8_t)(k + idx);
-
-			if (GetBus()->StartWrite(eeprom_addr[bank], &ch, 1) != 1)
-			{
-				return GetBus()->Error();
-			}
-
-			if (GetBus()->Read(eeprom_addr[bank], copy_buf + k, 1) != 1)
+			if (GetBus()->ReadBlock(eeprom_addr[bank], idx + k, 1, copy_buf + k, 1) != 1)
 			{
 				return GetBus()->Error();
 			}
@@ -449,12 +469,9 @@ int E24xx::BankRollOverDetect(int force)
 
 			int k;
 
-			for (k = timeout_loop; k > 0 && GetBus()->Read(eeprom_addr[1], buf, 1) != 1; k--)
-				;
-
-			if (k == 0)
+			if ((k = WaitWriteCycle(eeprom_addr[1])) != OK)
 			{
-				return E2P_TIMEOUT;
+				return k;
 			}
 
 			//Ok, ora procedi all roll-over detect
@@ -481,12 +498,9 @@ int E24xx::BankRollOverDetect(int force)
 				return GetBus()->Error();
 			}
 
-			for (k = timeout_loop; k > 0 && GetBus()->Read(eeprom_addr[1], buf, 1) != 1; k--)
-				;
-
-			if (k == 0)
+			if ((k = WaitWriteCycle(eeprom_addr[1])) != OK)
 			{
-				return E2P_TIMEOUT;
+				return k;
 			}
 		}
 	}
@@ -44,6 +44,12 @@ class E24xx : public Device
 	int Probe(int probe_size = 0);
 	int Read(int probe = 1, int type = ALL_TYPE);
 	int Write(int probe = 1, int type = ALL_TYPE);
+
+	bool CanDeltaWrite() const
+	{
+		return true;
+	}
+
 	int Verify(int type = ALL_TYPE);
 
 	int BankRollOverDetect(int force);
@@ -68,6 +74,17 @@ class E24xx : public Device
 	virtual int bank_out(uint8_t const *copy_buf, int bank_no, long size = -1, long idx = 0);
 	virtual int bank_in(uint8_t *copy_buf, int bank_no, long size = -1, long idx = 0);
 
+	int WaitWriteCycle(int addr);
+
+	//word address bytes of the block transfers, 0 if the device
+	// doesn't use ReadBlock() (no speed calibration then)
+	virtual int GetAddrBytes() const
+	{
+		return 1;
+	}
+
+	int GetWritePageSize() const;
+
 	//-- Parte riguardante la EEPROM
 	int sequential_read;                    //1 --> legge un banco in una volta
 	int writepage_size;                             //se > 1 scrive una pagina alla volta
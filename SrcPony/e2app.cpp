@@ -33,12 +33,6 @@
 
 #include <QDebug>
 
-#ifdef  __linux__
-#include <sys/time.h>
-#include <unistd.h>
-#include <signal.h>
-#endif
-
 #include "microbus.h"
 
 //const int idAskToSave = 100; // Dummy Command
@@ -46,6 +40,7 @@
 //=========================>>> e2App::e2App <<<==========================
 e2App::e2App() :
 	awip(0),
+	polarity_control(0),
 	port_number(0)
 {
 	// Constructor
@@ -192,8 +187,11 @@ void e2App::initSettings()
 	E2Profile::GetGpioPinCtrl();
 	E2Profile::GetGpioPinDataIn();
 	E2Profile::GetGpioPinDataOut();
+	E2Profile::GetGpioChipDev();
+	E2Profile::GetGpioMemSoc();
 #endif
 
+	E2Profile::GetVirtualTarget();
 	E2Profile::GetDevName();
 #endif
 
@@ -212,6 +210,9 @@ int e2App::OpenPort(int port)
 	}
 
 	ClosePort();
+
+	BUSTRACE(TRACE_NOPIN, 0, TRACE_OPEN);
+
 	return iniBus->Open(GetPort());
 }
 
@@ -221,6 +222,8 @@ void e2App::ClosePort()
 {
 	qDebug() << "e2App::ClosePort() iniBus=" << (hex) << iniBus << (dec);
 	iniBus->Close();
+
+	BUSTRACE(TRACE_NOPIN, 0, TRACE_CLOSE);
 }
 
 //=====================>>> e2App::TestPort <<<==============================
@@ -246,6 +249,12 @@ int e2App::OpenBus(BusIO *p)
 
 	qDebug() << "e2App::OpenBus() ** Close";
 
+	//the trace holds a single bus session, dumped by SleepBus()
+#ifdef  ENABLE_BUSTRACE
+	BusTrace::Clear();
+#endif
+	BUSTRACE(TRACE_NOPIN, 0, TRACE_OPEN);
+
 	iniBus = p;
 	int rv = iniBus->Open(GetPort());
 
@@ -278,6 +287,11 @@ void e2App::SleepBus()
 	iniBus->WaitMsec(5);    // 08/04/98 -- hold time dell'alimentazione
 	busIntp->SetPower(false);
 	iniBus->Close();                // 28/09/98 -- richiude la porta dopo averla usata
+
+	BUSTRACE(TRACE_NOPIN, 0, TRACE_CLOSE);
+#ifdef  ENABLE_BUSTRACE
+	BusTrace::DumpVCD(BusTrace::GetDefaultFile());
+#endif
 }
 
 
@@ -346,11 +360,31 @@ int e2App::Calibration()
 {
 	qDebug() << "e2App::Calibration()";
 
-	int rv = OK;
-	//      OpenBus(&iicB);         //aggiunto il 06/03/98
-	LookForBogoMips();
-	//      rv = iicB.Calibration();
-	//      SleepBus();                     //aggiunto il 06/03/98
+	//Measure again the timing profile of this machine
+	Wait w;
+	int rv = w.Calibrate(true);
+
+	if (rv != OK)
+	{
+		return rv;
+	}
+
+	//Check the delays really achieved by the timing engine
+	WaitTestResult res[] =
+	{
+		{ 1, 0, 0, 0 },
+		{ 5, 0, 0, 0 },
+		{ 20, 0, 0, 0 },
+		{ 100, 0, 0, 0 },
+		{ 1000, 0, 0, 0 }
+	};
+	int err = w.SelfTest(res, sizeof(res) / sizeof(res[0]));
+
+	qDebug() << "e2App::Calibration() engine =" << Wait::GetEngine()->GetName() << ", worst delay error =" << err << "%";
+
+	//the learned I2C speeds depend on the timing too, measure them again
+	E2Profile::ClearI2CBestDelay();
+
 	return rv;
 }
 
@@ -450,12 +484,29 @@ void e2App::SetInterfaceType(HInterfaceType type)
 		busIntp = &linuxsysfs_ioI;
 		break;
 
+	case LINUXGPIOCHIP_IO:
+		iType = LINUXGPIOCHIP_IO;
+		busIntp = &linuxgpiochip_ioI;
+		break;
+
+	case LINUXGPIOMEM_IO:
+		iType = LINUXGPIOMEM_IO;
+		busIntp = &linuxgpiomem_ioI;
+		break;
+
+	case VIRTUAL_IO:
+		iType = VIRTUAL_IO;
+		busIntp = &virtual_ioI;
+		break;
+
 	default:
 		iType = SIPROG_API;             //20/07/99 -- to prevent crash
 		busIntp = &siprog_apiI;
 		break;
 	}
 
+	busIntp->SetPolarity(polarity_control);
+
 	int k;
 
 	for (k = 0; k < NO_OF_BUSTYPE; k++)
@@ -464,191 +515,6 @@ void e2App::SetInterfaceType(HInterfaceType type)
 	}
 }
 
-#ifdef  __unix__
-static volatile int alarm_caught;
-
-static void alarm(int i)
-{
-	(void)i;
-	alarm_caught = 1;
-}
-#endif
-
-#define N_SAMPLE        4
-#define N_CICLI 8000
-#define UDELAY  40
-#define MSLICE  ((float)UDELAY * N_CICLI / 1000.0)
-
-void e2App::LookForBogoMips()
-{
-#ifdef  __unix__
-	struct itimerval it;
-
-	it.it_interval.tv_sec = 0;
-	it.it_interval.tv_usec = 0;
-
-	it.it_value.tv_sec = 0;
-	it.it_value.tv_usec = 500000;
-
-	signal(SIGALRM, alarm);
-
-	long ndel[N_SAMPLE];
-	int k;
-
-	for (k = 0; k < N_SAMPLE; k++)
-	{
-		setitimer(ITIMER_REAL, &it, NULL);
-		alarm_caught = 0;
-		long j = 0;
-
-		while (!alarm_caught)
-		{
-			j++;
-		}
-
-		ndel[k] = j;
-
-		//      fprintf(stderr, "** %ld\n", j);
-	}
-
-	long sum = 0;
-
-	for (k = 0; k < N_SAMPLE; k++)
-	{
-		sum += ndel[k];
-	}
-
-	E2Profile::SetBogoMips((int)(sum / (500 * N_SAMPLE)));
-#else
-	DWORD t0;
-	DWORD count;
-	DWORD multiplier = 1;
-
-	QString strbuf;
-	strbuf = helpfile;
-
-	int sp = strbuf.lastIndexOf("\\");
-
-	if (sp < 0)
-	{
-		sp = strbuf.lastIndexOf("/");
-	}
-
-	if (sp < 0)
-	{
-		strbuf = "bogomips.out";
-	}
-	else
-	{
-		strbuf += "bogomips.out";
-	}
-
-	QFile fh(strbuf);
-
-	if (!fh.open(QIODevice::WriteOnly | QIODevice::Text))
-	{
-		return;
-	}
-
-	QTextStream out(&fh);
-
-	Wait w;
-	int k;
-
-	w.SetHwTimer(0);        //Disable Hw timer for bogomips calibration
-
-	// First BogoMIPS evaluation
-	do
-	{
-		multiplier *= 5;
-
-		E2Profile::SetBogoMips(700 * multiplier);
-		w.SetBogoKips();
-
-		t0 = GetTickCount();
-
-		for (k = 0; k < N_CICLI / 10; k++)
-		{
-			w.WaitUsec(UDELAY);
-		}
-
-		count = GetTickCount() - t0;
-
-		out << "bogo = " << E2Profile::GetBogoMips() << ", count =" << count << "\n";
-	}
-	while (count <= MSLICE / 11);
-
-	t0 = GetTickCount();
-
-	for (k = 0; k < N_CICLI; k++)
-	{
-		w.WaitUsec(UDELAY);
-	}
-
-	count = GetTickCount() - t0;
-
-	out << "1) count = " << count << " ** mslice = " << MSLICE << " *** bogo = " << E2Profile::GetBogoMips() << "\n";
-
-	int j;
-
-	//Fast correction
-	for (j = 0; count > (MSLICE * 1.01) && j < 10; j++)
-	{
-		int nv;
-
-		nv = (DWORD)((float) E2Profile::GetBogoMips() * (MSLICE / (float)count) + 0.5);
-		E2Profile::SetBogoMips(nv);
-		w.SetBogoKips();
-
-		t0 = GetTickCount();
-
-		for (k = 0; k < N_CICLI; k++)
-		{
-			w.WaitUsec(UDELAY);
-		}
-
-		count = GetTickCount() - t0;
-
-		out << "2) count = " << count << " ** mslice = " << MSLICE << " *** bogo = " << E2Profile::GetBogoMips() << "\n";
-	}
-
-	//Fine correction
-	for (j = 0; count < (MSLICE * 0.99) && j < 10; j++)
-	{
-		int nv;
-
-		nv = (DWORD)((float) E2Profile::GetBogoMips() * 1.01 + 0.5);
-		E2Profile::SetBogoMips(nv);
-		w.SetBogoKips();
-
-		t0 = GetTickCount();
-
-		for (k = 0; k < N_CICLI; k++)
-		{
-			w.WaitUsec(UDELAY);
-		}
-
-		count = GetTickCount() - t0;
-
-		out << "3) count = " << count << " ** mslice = " << MSLICE << " *** bogo = " << E2Profile::GetBogoMips() << "\n";
-	}
-
-	w.CheckHwTimer();       //Check to enable again Hw timer
-
-	if (w.GetHwTimer())
-	{
-		out << "Hardware timer is OK.\n";
-	}
-	else
-	{
-		out << "Hardware timer is too slow, use bogomips (" << E2Profile::GetBogoMips() << ")\n";
-	}
-
-	fh.close();
-#endif
-}
-
-
 int e2App::LoadDriver(int start)
 {
 	int rv = OK;
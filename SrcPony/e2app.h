@@ -60,8 +60,12 @@
 //#include "jdmiointer.h"
 #include "dt006interf.h"
 #include "linuxsysfsint.h"
+#include "linuxgpiochipint.h"
+#include "linuxgpiomemint.h"
+#include "virtualint.h"
 
 #include "e2profil.h"
+#include "progworker.h"
 
 class e2AppWinInfo;
 
@@ -123,6 +127,15 @@ class e2App : public cTranslator
 
 	int Calibration();
 
+	ProgWorker *GetProgWorker()
+	{
+		return &progWorker;
+	}
+	ProgStatus *GetProgStatus()
+	{
+		return progWorker.GetStatus();
+	}
+
 	QString GetHelpFile() const
 	{
 		return helpfile;
@@ -143,6 +156,7 @@ class e2App : public cTranslator
 	void SetPolarity(uint8_t val)
 	{
 		polarity_control = val;
+		busIntp->SetPolarity(val);      //refresh the interface cache
 	}
 	int GetPort() const
 	{
@@ -179,7 +193,6 @@ class e2App : public cTranslator
 
   private:              //--------------------------------------- private
 	void initSettings();
-	void LookForBogoMips(); //should get bogomips
 
 	// EK 2017
 	// we can fork the process
@@ -194,6 +207,8 @@ class e2App : public cTranslator
 
 	uint8_t polarity_control; //polarity for control lines
 
+	ProgWorker progWorker;  //device operations run on this thread
+
 	//AutoTag
 	//List of available interface types
 	SIProgInterface siprog_apiI;
@@ -207,6 +222,9 @@ class e2App : public cTranslator
 	JdmInterface jdm_apiI;
 	//      JdmIOInterface jdm_ioI;
 	LinuxSysFsInterface linuxsysfs_ioI;
+	LinuxGpioChipInterface linuxgpiochip_ioI;
+	LinuxGpioMemInterface linuxgpiomem_ioI;
+	VirtualBusInterface virtual_ioI;
 
 	int port_number;        //port number used
 	BusIO *iniBus;                           //pointer to current Bus
@@ -40,7 +40,7 @@
 //======================>>> e2AppWinInfo::e2AppWinInfo <<<=======================
 e2AppWinInfo::e2AppWinInfo(e2CmdWindow *p, const QString &name, BusIO **busvptr) :
 	hex_per_line(16),
-	buffer_size(BUFFER_SIZE),
+	buffer_size(BUFFER_MIN_SIZE),
 	load_type(ALL_TYPE),
 	save_type(ALL_TYPE),
 	load_relocation(0),
@@ -58,6 +58,10 @@ e2AppWinInfo::e2AppWinInfo(e2CmdWindow *p, const QString &name, BusIO **busvptr)
 {
 	qDebug() << "e2AppWinInfo::e2AppWinInfo()";
 
+	buffer = new uint8_t[buffer_size];
+	memset(buffer, 0xFF, buffer_size);
+	used_map = 0;
+
 	// Constructor
 //	cmdWin = static_cast<e2CmdWindow*>(p);
 
@@ -237,6 +241,9 @@ e2AppWinInfo::~e2AppWinInfo()
 
 	// Destructor
 	fname = "";
+
+	delete[] buffer;
+	delete[] used_map;
 }
 
 
@@ -263,11 +270,15 @@ bool e2AppWinInfo::SetFileName(const QString &name)
 
 void e2AppWinInfo::SleepBus()
 {
+	eep->GetBus()->SavePollTimes();
 	cmdWin->SleepBus();
 }
 
 int e2AppWinInfo::OpenBus()
 {
+	//write cycle times learned for this device
+	eep->GetBus()->SetPollType(GetEEPId());
+
 	return cmdWin->OpenBus(eep->GetBus());
 }
 
@@ -307,6 +318,7 @@ void e2AppWinInfo::SetEEProm(unsigned long id)
 	//Setting the device pointer to selected type
 	case E24XX:
 		eep = eep24xx;
+		eep->SetProgPageSize(GetEEPTypeWPageSize(GetEEPId()), false);
 		break;
 
 	case E24XX1_A:
@@ -340,6 +352,7 @@ void e2AppWinInfo::SetEEProm(unsigned long id)
 			eep_subtype = GetE2PSubType(E2432);
 		}
 
+		eep->SetProgPageSize(GetEEPTypeWPageSize(GetEEPId()), false);
 		eep->DefaultBankSize();
 		break;
 
@@ -359,9 +372,12 @@ void e2AppWinInfo::SetEEProm(unsigned long id)
 
 		long xtype = GetEEPId();
 		eep->SetProgPageSize(GetEEPTypeWPageSize(xtype), false);
+		eep->SetProgPageSize(GetEEPTypeWPageSize(xtype), true);       //read in page sized bursts
+		eep->SetDataPageSize(GetEEPTypeEPageSize(xtype), false);      //EEPROM page write
 		At90sBus *b = static_cast<At90sBus *>(eep->GetBus());
 		b->SetFlashPagePolling((xtype != ATmega603) && (xtype != ATmega103));
 		b->SetOld1200Mode((xtype == AT90S1200));
+		b->SetRdyBsyPolling((GetEEPTypeFlags(xtype) & AVR_RDYBSY) != 0);
 		break;
 	}
 
@@ -402,6 +418,8 @@ void e2AppWinInfo::SetEEProm(unsigned long id)
 			eep_subtype = GetE2PSubType(E9306);
 		}
 
+		static_cast<At93cBus *>(eep->GetBus())->SetSequentialRead(
+			E2Profile::GetMicrowireSeqRead() && !(GetEEPTypeFlags(GetEEPId()) & MW_WORDREAD));
 		break;
 
 	case E93XX_8:
@@ -413,6 +431,8 @@ void e2AppWinInfo::SetEEProm(unsigned long id)
 			eep_subtype = GetE2PSubType(E9306_8);
 		}
 
+		static_cast<At93cBus *>(eep->GetBus())->SetSequentialRead(
+			E2Profile::GetMicrowireSeqRead() && !(GetEEPTypeFlags(GetEEPId()) & MW_WORDREAD));
 		break;
 
 	case PIC16XX:
@@ -527,13 +547,70 @@ void e2AppWinInfo::SetEEProm(unsigned long id)
 	fuse_ok = false;                //invalidate current fuse settings
 	SetSplittedInfo(GetEEPTypeSplit(id));
 
-	//Imposta la nuova dimensione della memoria in
-	// base al tipo di eeprom.
-	SetNoOfBlock(GetEEPTypeSize(id));
-
 	//Imposta la dimensione del banco che dipende
 	// dal tipo di eeprom.
 	SetBlockSize(eep->GetBankSize());
+
+	//Imposta la nuova dimensione della memoria in
+	// base al tipo di eeprom (e del buffer).
+	SetNoOfBlock(GetEEPTypeSize(id));
+
+	//The buffer is sized only here, on the GUI thread and before any
+	// operation: Probe() just updates the bank count, so the buffer never
+	// moves while a device operation holds pointers into it
+	if (GetNoOfBlock() == AUTOSIZE_ID)
+	{
+		SetBufSize(BUFFER_AUTOSIZE, true);
+	}
+	else
+	{
+		SetBufSize(GetSize(), true);
+	}
+}
+
+//Resize the buffer for a device of size bytes, the content is kept
+// and the new locations are blank. It shrinks only if fit is true,
+// never below BUFFER_MIN_SIZE.
+void e2AppWinInfo::SetBufSize(long size, bool fit)
+{
+	size = (size + BUFFER_PAGE - 1) / BUFFER_PAGE * BUFFER_PAGE;
+
+	if (size < BUFFER_MIN_SIZE)
+	{
+		size = BUFFER_MIN_SIZE;
+	}
+
+	if (size == buffer_size || (size < buffer_size && !fit))
+	{
+		return;
+	}
+
+	qDebug() << "e2AppWinInfo::SetBufSize() " << buffer_size << " -> " << size;
+
+	long keep = (size < buffer_size) ? size : buffer_size;
+	uint8_t *newbuf = new uint8_t[size];
+
+	memcpy(newbuf, buffer, keep);
+	memset(newbuf + keep, 0xFF, size - keep);
+
+	delete[] buffer;
+	buffer = newbuf;
+
+	if (used_map)
+	{
+		//the new pages are blank, not populated
+		long old_pages = keep / USED_PAGE_SIZE;
+		long pages = size / USED_PAGE_SIZE;
+		uint8_t *newmap = new uint8_t[pages];
+
+		memset(newmap, 0, pages);
+		memcpy(newmap, used_map, old_pages);
+
+		delete[] used_map;
+		used_map = newmap;
+	}
+
+	buffer_size = size;
 }
 
 //======================>>> e2AppWinInfo::Read <<<=======================
@@ -582,6 +659,7 @@ int e2AppWinInfo::Read(int type, int raise_power, int leave_on)
 			SetFileName("");          //avoid to use old name on next save()
 			buf_ok = true;
 			buf_changed = false;
+			ClearUsedMap();           //the whole image comes from the device
 
 			//Aggiunto il 18/03/99 con la determinazione dei numeri di banchi nelle E24xx2,
 			// affinche` la dimensione rimanga quella impostata bisogna correggere la dimensione
@@ -619,6 +697,21 @@ int e2AppWinInfo::Write(int type, int raise_power, int leave_on)
 	{
 		//              CheckEvents();
 
+		uint8_t *delta = 0;
+
+		if (E2Profile::GetDeltaWrite() && eep->CanDeltaWrite() && (type & (PROG_TYPE | DATA_TYPE)))
+		{
+			delta = ReadDeltaImage(probe, type & (PROG_TYPE | DATA_TYPE));
+		}
+
+		//Sparse write: skip the pages the loaded file didn't populate
+		bool sparse = HasUsedMap() && E2Profile::GetSparseWrite() && eep->CanDeltaWrite();
+
+		if (sparse)
+		{
+			eep->GetBus()->SetUsedMap(GetBufPtr(), used_map, GetBufSize(), USED_PAGE_SIZE);
+		}
+
 		if ((rval = eep->Write(probe, type)) > 0)
 		{
 			//Aggiunto il 18/03/99 con la determinazione dei numeri di banchi nelle E24xx2,
@@ -627,6 +720,21 @@ int e2AppWinInfo::Write(int type, int raise_power, int leave_on)
 			SetBlockSize(eep->GetBankSize());
 		}
 
+		if (delta)
+		{
+			qDebug() << "e2AppWinInfo::Write() delta skipped " << eep->GetBus()->GetDeltaSkipped() << " bytes";
+
+			eep->GetBus()->ClearDeltaImage();
+			delete[] delta;
+		}
+
+		if (sparse)
+		{
+			qDebug() << "e2AppWinInfo::Write() sparse skipped " << eep->GetBus()->GetUnusedSkipped() << " bytes";
+
+			eep->GetBus()->ClearUsedMap();
+		}
+
 		if (!(rval > 0 && leave_on))            //23/01/1999
 		{
 			SleepBus();
@@ -638,6 +746,39 @@ int e2AppWinInfo::Write(int type, int raise_power, int leave_on)
 	return rval;
 }
 
+//Read back the device content so that the bus can skip the pages
+// that already hold the buffer data. The buffer is left untouched.
+// Return the delta image (to be deleted by the caller) or 0 if the
+// read fails, in that case a full write is done.
+uint8_t *e2AppWinInfo::ReadDeltaImage(int probe, int type)
+{
+	long size = GetBufSize();
+	uint8_t *wanted = new uint8_t[size];
+	uint8_t *delta = 0;
+
+	memcpy(wanted, GetBufPtr(), size);
+
+	if (eep->Read(probe, type) > 0)
+	{
+		delta = new uint8_t[size];
+		memcpy(delta, GetBufPtr(), size);
+	}
+
+	memcpy(GetBufPtr(), wanted, size);
+	delete[] wanted;
+
+	if (delta)
+	{
+		eep->GetBus()->SetDeltaImage(GetBufPtr(), delta, size);
+	}
+	else
+	{
+		qDebug() << "e2AppWinInfo::ReadDeltaImage() read failed, full write";
+	}
+
+	return delta;
+}
+
 //======================>>> e2AppWinInfo::Verify <<<=======================
 int e2AppWinInfo::Verify(int type, int raise_power, int leave_on)
 {
@@ -652,8 +793,21 @@ int e2AppWinInfo::Verify(int type, int raise_power, int leave_on)
 
 	if (rval == OK)
 	{
+		//Verify only the pages the loaded file populated
+		bool sparse = HasUsedMap() && E2Profile::GetSparseWrite() && eep->CanDeltaWrite();
+
+		if (sparse)
+		{
+			eep->GetBus()->SetUsedMap(GetBufPtr(), used_map, GetBufSize(), USED_PAGE_SIZE);
+		}
+
 		rval = eep->Verify(type);
 
+		if (sparse)
+		{
+			eep->GetBus()->ClearUsedMap();
+		}
+
 		if (!(rval >= 0 && leave_on))
 		{
 			SleepBus();
@@ -741,6 +895,8 @@ int e2AppWinInfo::Load()
 			if (GetE2PPriType(GetEEPId()) == PIC16XX ||
 					GetE2PPriType(GetEEPId()) == PIC168XX)
 			{
+				ClearUsedMap();         //the relocated areas are not tracked
+
 				//It seems a bit tricky...
 				//Relocate the DATA and CONFIG memory with PIC devices
 				//The assembler store the DATA at 0x2100 (word address) and
@@ -776,6 +932,8 @@ int e2AppWinInfo::Load()
 			}
 			else if (GetE2PPriType(GetEEPId()) == PIC125XX)
 			{
+				ClearUsedMap();
+
 				//Copy Config memory
 				if (GetSize() + 16 <= GetBufSize())
 				{
@@ -816,6 +974,17 @@ int e2AppWinInfo::LoadFile()
 		}
 	}
 
+	//The HEX and S-record loaders record the pages they populate, the
+	// rest of a cleared buffer is left unwritten. The other formats
+	// (and a load over the old content) define the whole image.
+	ClearUsedMap();
+
+	if (clear_buffer_before_load && load_type == ALL_TYPE &&
+			(GetFileBuf() == INTEL || GetFileBuf() == MOTOS))
+	{
+		StartUsedMap();
+	}
+
 	int rval = fbufp->Load(load_type, load_relocation);
 
 	if (rval > 0)
@@ -823,6 +992,10 @@ int e2AppWinInfo::LoadFile()
 		buf_ok = true;
 		buf_changed = false;
 	}
+	else
+	{
+		ClearUsedMap();
+	}
 
 	RecalcCRC();
 
@@ -1134,9 +1307,80 @@ void e2AppWinInfo::ClearBuffer(int type)
 		memset(GetBufPtr() + s, 0xFF, GetSize() - s);
 	}
 
+	ClearUsedMap();
 	RecalcCRC();
 }
 
+//Start tracking the pages populated by a file load, none so far
+void e2AppWinInfo::StartUsedMap()
+{
+	long pages = buffer_size / USED_PAGE_SIZE;
+
+	if (used_map == 0)
+	{
+		used_map = new uint8_t[pages];
+	}
+
+	memset(used_map, 0, pages);
+}
+
+void e2AppWinInfo::ClearUsedMap()
+{
+	delete[] used_map;
+	used_map = 0;
+}
+
+void e2AppWinInfo::SetUsed(long addr, long len)
+{
+	if (used_map == 0 || len <= 0 || addr < 0 || addr >= buffer_size)
+	{
+		return;
+	}
+
+	if (addr + len > buffer_size)
+	{
+		len = buffer_size - addr;
+	}
+
+	long last = (addr + len - 1) / USED_PAGE_SIZE;
+
+	for (long k = addr / USED_PAGE_SIZE; k <= last; k++)
+	{
+		used_map[k] = 1;
+	}
+}
+
+//True if any location in the range was populated (always without a map)
+bool e2AppWinInfo::IsUsed(long addr, long len) const
+{
+	if (used_map == 0)
+	{
+		return true;
+	}
+
+	if (len <= 0 || addr < 0 || addr >= buffer_size)
+	{
+		return false;
+	}
+
+	if (addr + len > buffer_size)
+	{
+		len = buffer_size - addr;
+	}
+
+	long last = (addr + len - 1) / USED_PAGE_SIZE;
+
+	for (long k = addr / USED_PAGE_SIZE; k <= last; k++)
+	{
+		if (used_map[k])
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
 void e2AppWinInfo::FillBuffer(int init_pos, int ch, long len)
 {
 	long l;
@@ -1170,6 +1414,7 @@ void e2AppWinInfo::FillBuffer(int init_pos, int ch, long len)
 
 	memset(GetBufPtr() + init_pos, ch, l);
 
+	ClearUsedMap();
 	RecalcCRC();
 	BufChanged();
 }
@@ -1187,6 +1432,7 @@ void e2AppWinInfo::SwapBytes()
 		buffer[k + 1] = tmp;
 	}
 
+	ClearUsedMap();
 	RecalcCRC();
 	BufChanged();
 }
@@ -1203,6 +1449,8 @@ void e2AppWinInfo::DoubleSize()
 	//      int n = GetNoOfBlock();
 	int k;
 
+	SetBufSize(GetSize() * 2);
+
 	for (k = GetNoOfBlock() - 1; k >= 0; k--)
 	{
 		//Copia l'ultimo banco nei due banchi in fondo
@@ -1221,6 +1469,7 @@ void e2AppWinInfo::DoubleSize()
 			  );
 	}
 
+	ClearUsedMap();
 	RecalcCRC();
 	BufChanged();
 }
@@ -71,8 +71,15 @@
 #include "e2phead.h"
 
 
-//At the moment the bigger device is ATmega2560 (256KiB + 4KiB)
-#define BUFFER_SIZE (1024 * 260)
+//The buffer has the size of the selected device rounded up to BUFFER_PAGE,
+// DoubleSize() may grow it further. BUFFER_MIN_SIZE leaves room for the
+// fixed PIC config and EEPROM offsets of the file loaders and for probed banks.
+#define BUFFER_MIN_SIZE (1024 * 64)
+#define BUFFER_AUTOSIZE (1024 * 260)    //device size known only after probe
+#define BUFFER_PAGE     4096
+
+//Granularity of the map of the buffer pages populated by a file load
+#define USED_PAGE_SIZE  64
 
 
 #define STRINGID_SIZE   E2P_STRID_SIZE
@@ -207,6 +214,17 @@ class e2AppWinInfo // : public QObject
 	void FillBuffer(int first_pos = 0, int ch = 0xFF, long len = -1);
 	void ClearBuffer(int type = ALL_TYPE);
 
+	//Sparse image: the HEX and S-record loaders record the pages they
+	// populate, without a map the whole buffer is meaningful
+	void StartUsedMap();
+	void ClearUsedMap();
+	bool HasUsedMap() const
+	{
+		return used_map != 0;
+	}
+	void SetUsed(long addr, long len);
+	bool IsUsed(long addr, long len) const;
+
 	int SecurityRead(uint32_t &bits);
 	int SecurityWrite(uint32_t bits, bool no_param = false);
 	int FusesRead(uint32_t &bits);
@@ -285,12 +303,14 @@ class e2AppWinInfo // : public QObject
 	{
 		block_size = blk;
 	}
+	void SetBufSize(long size, bool fit = false);
 	int LoadFile();
+	uint8_t *ReadDeltaImage(int probe, int type);
 
 	QString fname;                            //nome del file
 
 	int const hex_per_line;
-	int const buffer_size;
+	int buffer_size;
 
 	int load_type;                          //load ALL, Flash only or EEPROM only
 	int save_type;                          //save ALL, Flash only or EEPROM only
@@ -301,9 +321,8 @@ class e2AppWinInfo // : public QObject
 	bool clear_buffer_before_load;          //flag, clear buffer before load a file
 	//      bool clear_buffer_before_read;          //flag, clear buffer before read from device
 
-	// EK 2017
-	// TODO convert to QByteArray or QBuffer?
-	uint8_t buffer[BUFFER_SIZE];    //device content buffer
+	uint8_t *buffer;                //device content buffer
+	uint8_t *used_map;              //one entry per USED_PAGE_SIZE bytes of buffer, 0 if not tracked
 	QString linebuf;//[LINEBUF_SIZE];     //print line buffer
 	bool buf_ok;                            //true if buffer is valid
 	bool buf_changed;                       //true if buffer changed/edited
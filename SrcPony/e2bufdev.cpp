@@ -0,0 +1,105 @@
+//=========================================================================//
+//                                                                         //
+//  PonyProg - Serial Device Programmer                                    //
+//                                                                         //
+//  Copyright (C) 1997-2017   Claudio Lanconelli                           //
+//                                                                         //
+//  http://ponyprog.sourceforge.net                                        //
+//                                                                         //
+//-------------------------------------------------------------------------//
+//                                                                         //
+// This program is free software; you can redistribute it and/or           //
+// modify it under the terms of the GNU  General Public License            //
+// as published by the Free Software Foundation; either version2 of        //
+// the License, or (at your option) any later version.                     //
+//                                                                         //
+// This program is distributed in the hope that it will be useful,         //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of          //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       //
+// General Public License for more details.                                //
+//                                                                         //
+// You should have received a copy of the GNU  General Public License      //
+// along with this program (see LICENSE);     if not, write to the         //
+// Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA. //
+//                                                                         //
+//=========================================================================//
+
+
+#include "e2bufdev.h"
+#include "e2awinfo.h"
+
+#include <QDebug>
+#include <string.h>
+
+e2BufDevice::e2BufDevice(QObject *parent)
+	: QIODevice(parent),
+	  awip(0),
+	  dirty_bytes(0)
+{
+}
+
+qint64 e2BufDevice::size() const
+{
+	return awip ? awip->GetSize() : 0;
+}
+
+qint64 e2BufDevice::readData(char *data, qint64 maxlen)
+{
+	qint64 n = size() - pos();
+
+	if (n > maxlen)
+	{
+		n = maxlen;
+	}
+
+	if (n <= 0)
+	{
+		return 0;
+	}
+
+	memcpy(data, awip->GetBufPtr() + pos(), n);
+
+	return n;
+}
+
+qint64 e2BufDevice::writeData(const char *data, qint64 len)
+{
+	qint64 n = size() - pos();
+
+	if (n > len)
+	{
+		n = len;
+	}
+
+	if (n <= 0)
+	{
+		return -1;
+	}
+
+	long base = (long)pos();
+	uint8_t *buf = awip->GetBufPtr() + base;
+	uint8_t const *src = reinterpret_cast<uint8_t const *>(data);
+	long k = 0;
+
+	while (k < n)
+	{
+		if (buf[k] == src[k])
+		{
+			k++;
+			continue;
+		}
+
+		long start = k;
+
+		while (k < n && buf[k] != src[k])
+		{
+			k++;
+		}
+
+		memcpy(buf + start, src + start, k - start);
+		awip->SetUsed(base + start, k - start);
+		dirty_bytes += k - start;
+	}
+
+	return n;
+}
@@ -0,0 +1,81 @@
+//=========================================================================//
+//                                                                         //
+//  PonyProg - Serial Device Programmer                                    //
+//                                                                         //
+//  Copyright (C) 1997-2017   Claudio Lanconelli                           //
+//                                                                         //
+//  http://ponyprog.sourceforge.net                                        //
+//                                                                         //
+//-------------------------------------------------------------------------//
+//                                                                         //
+// This program is free software; you can redistribute it and/or           //
+// modify it under the terms of the GNU  General Public License            //
+// as published by the Free Software Foundation; either version2 of        //
+// the License, or (at your option) any later version.                     //
+//                                                                         //
+// This program is distributed in the hope that it will be useful,         //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of          //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       //
+// General Public License for more details.                                //
+//                                                                         //
+// You should have received a copy of the GNU  General Public License      //
+// along with this program (see LICENSE);     if not, write to the         //
+// Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA. //
+//                                                                         //
+//=========================================================================//
+
+
+#ifndef _E2BUFDEV_H
+#define _E2BUFDEV_H
+
+#include <QIODevice>
+
+#include "types.h"
+
+class e2AppWinInfo;
+
+//QIODevice over the e2AppWinInfo buffer, no copy of the data.
+//The hex editor reads it lazily, writes change only the bytes that
+// differ and mark them populated in the sparse image map.
+class e2BufDevice : public QIODevice
+{
+  public:               //---------------------------------------- public
+
+	e2BufDevice(QObject *parent = 0);
+
+	void SetAWInfo(e2AppWinInfo *awi)
+	{
+		awip = awi;
+	}
+
+	qint64 size() const;
+	bool isSequential() const
+	{
+		return false;
+	}
+
+	bool IsDirty() const
+	{
+		return dirty_bytes > 0;
+	}
+	long GetDirtyBytes() const
+	{
+		return dirty_bytes;
+	}
+	void ClearDirty()
+	{
+		dirty_bytes = 0;
+	}
+
+  protected:    //--------------------------------------- protected
+
+	qint64 readData(char *data, qint64 maxlen);
+	qint64 writeData(const char *data, qint64 len);
+
+  private:              //--------------------------------------- private
+
+	e2AppWinInfo *awip;
+	long dirty_bytes;               //bytes changed by the writes
+};
+
+#endif
@@ -36,7 +36,6 @@
 
 #include <QAbstractTextDocumentLayout>
 #include <QIODevice>
-#include <QBuffer>
 #include <QSound>
 #include <QTextDocument>
 #include <QProcess>
@@ -206,7 +205,7 @@ e2CmdWindow::e2CmdWindow(QWidget *parent) :
 	//      UpdateMenuType(E2Profile::GetLastDevType());
 
 	// The Canvas
-	qbuf = new QBuffer(this);
+	hexBuf = new e2BufDevice(this);
 	e2HexEdit = new QHexEdit(this); //e2TextCanvasPane(this);
 	setCentralWidget(e2HexEdit);
 	e2HexEdit->setFocus();
@@ -297,7 +296,7 @@ e2CmdWindow::~e2CmdWindow()
 
 	//      delete e2Menu;
 	delete e2HexEdit;
-	delete qbuf;
+	delete hexBuf;
 	// EK 2017
 	// TODO remove created QAction* lists and other
 
@@ -1361,6 +1360,50 @@ void e2CmdWindow::doProgress(const QString &text)
 	}
 }
 
+/**
+ * @brief run a device operation on the programming thread, the
+ * progress dialog only observes its status block
+ *
+ */
+int e2CmdWindow::RunProgrammer(std::function<int()> op)
+{
+	ProgWorker *w = GetProgWorker();
+	ProgStatus *st = w->GetStatus();
+
+	//the worker writes the buffer the hex editor reads: freeze the view
+	// while the events are processed
+	e2HexEdit->setUpdatesEnabled(false);
+	e2HexEdit->setEnabled(false);
+
+	//the worker reads and stores the settings on a copy
+	E2Profile::BeginWorker();
+	w->Start(op);
+
+	while (!w->wait(PROG_POLL_MSEC))
+	{
+		qApp->processEvents();
+
+		if (abortFlag || (e2Prg && e2Prg->wasCanceled()))
+		{
+			abortFlag = false;
+			st->SetAbort();
+		}
+
+		if (e2Prg)
+		{
+			e2Prg->setValue(st->GetProgress());
+		}
+	}
+
+	E2Profile::EndWorker();
+
+	e2HexEdit->setEnabled(true);
+	e2HexEdit->setUpdatesEnabled(true);
+	e2HexEdit->viewport()->update();
+
+	return w->GetResult();
+}
+
 /**
  * @brief SLOT from "cancel" of ProgressDialog
  *
@@ -2840,7 +2883,7 @@ int e2CmdWindow::CmdRead(int type)
 		awip->SetFileName("");
 		SetTitle();
 
-		rval = awip->Read(type);
+		rval = RunProgrammer([&]() { return awip->Read(type); });
 		e2Prg->reset();
 
 		if (rval > 0)
@@ -2952,7 +2995,7 @@ int e2CmdWindow::CmdWrite(int type, bool verify)
 
 				doProgress(translate(STR_MSGWRITING));
 
-				rval = awip->Write(type, true, verify ? true : false);
+				rval = RunProgrammer([&]() { return awip->Write(type, true, verify ? true : false); });
 
 				if (rval > 0)
 				{
@@ -2963,22 +3006,22 @@ int e2CmdWindow::CmdWrite(int type, bool verify)
 						if ((old_type & CONFIG_TYPE) &&
 								!(awip->GetFuseBits() == 0 && awip->GetLockBits() == 0))
 						{
-							rval = awip->Verify(type, false, true);
+							rval = RunProgrammer([&]() { return awip->Verify(type, false, true); });
 
 							if (rval > 0)
 							{
 								//e2Prg->UpdateDialog(0, translate(STR_MSGWRITINGFUSE));
-								rval = awip->Write(CONFIG_TYPE, false, true);
+								rval = RunProgrammer([&]() { return awip->Write(CONFIG_TYPE, false, true); });
 
 								if (rval > 0)
 								{
-									rval = awip->Verify(CONFIG_TYPE, false, false);
+									rval = RunProgrammer([&]() { return awip->Verify(CONFIG_TYPE, false, false); });
 								}
 							}
 						}
 						else
 						{
-							rval = awip->Verify(type, false, false);
+							rval = RunProgrammer([&]() { return awip->Verify(type, false, false); });
 						}
 					}
 
@@ -3117,6 +3160,7 @@ int e2CmdWindow::CmdReadCalibration(int idx)
 
 				*bp = (uint8_t)rval;
 
+				awip->SetUsed(loc, 1);
 				awip->RecalcCRC();
 				//awip->BufChanged();
 				// EK 2017
@@ -3211,7 +3255,7 @@ int e2CmdWindow::CmdErase(int type)
 
 		doProgress(translate(STR_MSGERASING));
 
-		rval = awip->Erase(type);
+		rval = RunProgrammer([&]() { return awip->Erase(type); });
 		e2Prg->reset();
 
 		if (rval > 0)
@@ -3287,7 +3331,7 @@ int e2CmdWindow::CmdVerify(int type)
 	{
 		doProgress(translate(STR_MSGVERIFING));
 
-		int rval = awip->Verify(type);
+		int rval = RunProgrammer([&]() { return awip->Verify(type); });
 		e2Prg->reset();
 
 		if (rval < 0)
@@ -5469,6 +5513,7 @@ int e2CmdWindow::CmdSetSerialNumber()
 			}
 		}
 
+		awip->SetUsed(loc, size);
 		awip->RecalcCRC();
 		//awip->BufChanged();
 
@@ -6520,9 +6565,20 @@ void e2CmdWindow::UpdateBuffer()
 {
 	if (e2HexEdit->isModified())
 	{
-		const char *ptr = e2HexEdit->data().constData();
-		memcpy(awip->GetBufPtr(), ptr, awip->GetSize());
-		awip->BufChanged();
+		//a second device on the same buffer: the editor reads the
+		// unmodified chunks from hexBuf while it writes here
+		e2BufDevice dev;
+
+		dev.SetAWInfo(awip);
+		e2HexEdit->write(dev);
+
+		qDebug() << "UpdateBuffer() " << dev.GetDirtyBytes() << " bytes changed";
+
+		if (dev.IsDirty())
+		{
+			awip->BufChanged();
+		}
+
 		Draw();
 	}
 }
@@ -6539,13 +6595,9 @@ void e2CmdWindow::Draw()
 		return;
 	}
 
-	qbuf->setData(reinterpret_cast<char *>(awip->GetBufPtr()), awip->GetSize());
-	//         dev.open();
-	//         dev.read(reinterpret_cast<char*>(awip->GetBufPtr()), awip->GetBufSize());
-
-	//      QByteArray databuf = QByteArray(reinterpret_cast<char*>(awip->GetBufPtr()), awip->GetBufSize());
-	// qDebug() << databuf;
-	e2HexEdit->setData(*qbuf);
+	//the editor reads the buffer lazily through hexBuf, no copy
+	hexBuf->SetAWInfo(awip);
+	e2HexEdit->setData(*hexBuf);
 	//         dev.close();
 #if 0
 	int no_line;
@@ -6654,14 +6706,6 @@ void e2CmdWindow::PostInit()
 
 	CmdSelectDevice(E2Profile::GetLastDevType(), true);
 
-	if (E2Profile::GetBogoMips() == 0)
-	{
-		QMessageBox note(QMessageBox::Information, "Calibration", translate(STR_MSGNEEDCALIB), QMessageBox::Close);
-		note.setStyleSheet(programStyleSheet);
-		note.setButtonText(QMessageBox::Close, translate(STR_CLOSE));
-		note.exec();
-	}
-
 	if (E2Profile::GetPortNumber() < 0)
 	{
 		QMessageBox note(QMessageBox::Information, "Setup", translate(STR_MSGNEEDSETUP), QMessageBox::Close);
@@ -54,6 +54,7 @@
 #include "Translator.h"
 #include "e2app.h"
 #include "e2awinfo.h"
+#include "e2bufdev.h"
 
 
 #include "ui_mainwindow.h"
@@ -315,6 +316,7 @@ class e2CmdWindow : public QMainWindow, public e2App, public Ui::MainWindow
 	int filterNameToIndex(const QString &s, const QStringList &lst);
 
 	void doProgress(const QString &text);
+	int RunProgrammer(std::function<int()> op);
 
 	void Draw(/*int rows = 0, int cols = 0*/);
 	void UpdateBuffer();
@@ -425,7 +427,7 @@ class e2CmdWindow : public QMainWindow, public e2App, public Ui::MainWindow
 
 	// Standard elements
 	QHexEdit *e2HexEdit;             // For the canvas
-	QBuffer *qbuf;
+	e2BufDevice *hexBuf;             // The buffer seen by the canvas
 
 	QProgressDialog *e2Prg;
 
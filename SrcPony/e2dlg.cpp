@@ -88,6 +88,7 @@ void e2Dialog::onSelectLPT(int i)
 {
 	interf_type = VindexToInterfType(1, i);
 	qDebug() << "IntefType: " << (int)interf_type << ", index = " << i << ", LPT";
+	chkSPIMinTiming->setChecked(E2Profile::GetSPIMinTiming(interf_type));
 //	interf_type = (HInterfaceType)(i + 3);
 }
 
@@ -96,6 +97,7 @@ void e2Dialog::onSelectCOM(int i)
 {
 	interf_type = VindexToInterfType(0, i);
 	qDebug() << "IntefType: " << (int)interf_type << ", index = " << i << ", COM";
+	chkSPIMinTiming->setChecked(E2Profile::GetSPIMinTiming(interf_type));
 //	interf_type = (HInterfaceType)i;
 }
 
@@ -161,6 +163,8 @@ void e2Dialog::onChangePort(bool b)
 			interf_type = VindexToInterfType(1, cbxInterfLPT->currentIndex());
 		}
 
+		chkSPIMinTiming->setChecked(E2Profile::GetSPIMinTiming(interf_type));
+
 		//connect(rdbComPort, SIGNAL(toggled(bool)), this, SLOT(onChangePort(bool)));
 		//connect(rdbLptPort, SIGNAL(toggled(bool)), this, SLOT(onChangePort(bool)));
 	}
@@ -218,6 +222,8 @@ void e2Dialog::getSettings()
 	chkPol2->setChecked((cmdWin->GetPolarity() & CLOCKINV) ? 1 : 0);
 	chkPol3->setChecked((cmdWin->GetPolarity() & DININV) ? 1 : 0);
 	chkPol4->setChecked((cmdWin->GetPolarity() & DOUTINV) ? 1 : 0);
+
+	chkSPIMinTiming->setChecked(E2Profile::GetSPIMinTiming(interf_type));
 }
 
 void e2Dialog::setSettings()
@@ -270,6 +276,7 @@ void e2Dialog::setSettings()
 	E2Profile::SetParInterfType(interf_type);
 	E2Profile::SetPortNumber(port_no);
 	E2Profile::SetPolarityControl(cmdWin->GetPolarity());
+	E2Profile::SetSPIMinTiming(interf_type, chkSPIMinTiming->isChecked());
 
 	qDebug() << "PortNo: " << port_no;
 }
@@ -298,6 +305,7 @@ void e2Dialog::setWidgetsText()
 	chkPol2->setText(translate(STR_LBLINVSCK));
 	chkPol3->setText(translate(STR_LBLINVDATAIN));
 	chkPol4->setText(translate(STR_LBLINVDATAOUT));
+	chkSPIMinTiming->setText(translate(STR_LBLSPIMINTIMING));
 
 	pushOk->setText(translate(STR_BTNOK));
 	pushTest->setText(translate(STR_BTNPROBE));
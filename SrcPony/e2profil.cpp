@@ -26,6 +26,7 @@
 
 #include <QDebug>
 #include <QFile>
+#include <QHash>
 #include <QString>
 #include <QStringList>
 #include <QSettings>
@@ -38,7 +39,177 @@
 #include "portint.h"
 
 //QSettings *E2Profile::s = new QSettings("ponyprog.ini", QSettings::IniFormat);
-QSettings *E2Profile::s = new QSettings(APP_NAME);
+E2Settings *E2Profile::s = new E2Settings(APP_NAME);
+
+E2Settings::E2Settings(const QString &name)
+	: settings(name),
+	  frozen(false)
+{
+}
+
+bool E2Settings::InGroup(const QString &key, const QString &group)
+{
+	return key == group || key.startsWith(group + "/");
+}
+
+//Drop the key and everything under it
+void E2Settings::Forget(QHash<QString, QVariant> &h, const QString &key)
+{
+	QStringList keys = h.keys();
+
+	for (int k = 0; k < keys.count(); k++)
+	{
+		if (InGroup(keys.at(k), key))
+		{
+			h.remove(keys.at(k));
+		}
+	}
+}
+
+QVariant E2Settings::value(const QString &key, const QVariant &def)
+{
+	QMutexLocker lock(&mtx);
+
+	if (!frozen)
+	{
+		return settings.value(key, def);
+	}
+
+	QString k = prefix + key;
+
+	if (changed.contains(k))
+	{
+		return changed.value(k);
+	}
+
+	return cache.value(k, def);
+}
+
+void E2Settings::setValue(const QString &key, const QVariant &val)
+{
+	QMutexLocker lock(&mtx);
+
+	if (!frozen)
+	{
+		settings.setValue(key, val);
+	}
+	else
+	{
+		changed.insert(prefix + key, val);
+	}
+}
+
+void E2Settings::remove(const QString &key)
+{
+	QMutexLocker lock(&mtx);
+
+	if (!frozen)
+	{
+		settings.remove(key);
+	}
+	else
+	{
+		QString k = prefix + key;
+
+		Forget(cache, k);
+		Forget(changed, k);
+		removed << k;
+	}
+}
+
+void E2Settings::beginGroup(const QString &name)
+{
+	QMutexLocker lock(&mtx);
+
+	if (!frozen)
+	{
+		settings.beginGroup(name);
+	}
+	else
+	{
+		prefix += name + "/";
+	}
+}
+
+void E2Settings::endGroup()
+{
+	QMutexLocker lock(&mtx);
+
+	if (!frozen)
+	{
+		settings.endGroup();
+	}
+	else
+	{
+		int n = prefix.lastIndexOf("/", -2);
+		prefix = (n < 0) ? QString() : prefix.left(n + 1);
+	}
+}
+
+void E2Settings::sync()
+{
+	QMutexLocker lock(&mtx);
+
+	if (!frozen)
+	{
+		settings.sync();
+	}
+}
+
+//Called on the GUI thread before the programming thread starts
+void E2Settings::Freeze()
+{
+	QMutexLocker lock(&mtx);
+
+	if (frozen)
+	{
+		return;
+	}
+
+	cache.clear();
+	changed.clear();
+	removed.clear();
+	prefix.clear();
+
+	QStringList keys = settings.allKeys();
+
+	for (int k = 0; k < keys.count(); k++)
+	{
+		cache.insert(keys.at(k), settings.value(keys.at(k)));
+	}
+
+	frozen = true;
+}
+
+//Called on the GUI thread once the programming thread has finished:
+// store what was learned meanwhile
+void E2Settings::Thaw()
+{
+	QMutexLocker lock(&mtx);
+
+	if (!frozen)
+	{
+		return;
+	}
+
+	frozen = false;
+
+	for (int k = 0; k < removed.count(); k++)
+	{
+		settings.remove(removed.at(k));
+	}
+
+	QStringList keys = changed.keys();
+
+	for (int k = 0; k < keys.count(); k++)
+	{
+		settings.setValue(keys.at(k), changed.value(keys.at(k)));
+	}
+
+	cache.clear();
+	changed.clear();
+	removed.clear();
+}
 
 //=====>>> Costruttore <<<======
 #if 0
@@ -92,6 +263,40 @@ void E2Profile::SetBogoMips(int value)
 	//      }
 }
 
+static QString TimingProfileGroup(const QString &signature)
+{
+	return "TimingProfile/" + QString::number(qHash(signature), 16) + "/";
+}
+
+bool E2Profile::GetTimingProfile(const QString &signature, TimingProfile &prof)
+{
+	QString grp = TimingProfileGroup(signature);
+
+	//A profile of a different CPU or governor is stale
+	if (s->value(grp + "Signature", "").toString() != signature)
+	{
+		return false;
+	}
+
+	prof.hwtimer = s->value(grp + "HwTimer", "0").toString().toInt();
+	prof.bogokips = s->value(grp + "BogoKips", "0").toString().toInt();
+	prof.clock_overhead = s->value(grp + "ClockOverhead", "0").toString().toLong();
+	prof.sleep_slack = s->value(grp + "SleepSlack", "0").toString().toLong();
+
+	return (prof.bogokips > 0);
+}
+
+void E2Profile::SetTimingProfile(const QString &signature, const TimingProfile &prof)
+{
+	QString grp = TimingProfileGroup(signature);
+
+	s->setValue(grp + "Signature", signature);
+	s->setValue(grp + "HwTimer", QString::number(prof.hwtimer));
+	s->setValue(grp + "BogoKips", QString::number(prof.bogokips));
+	s->setValue(grp + "ClockOverhead", QString::number(prof.clock_overhead));
+	s->setValue(grp + "SleepSlack", QString::number(prof.sleep_slack));
+}
+
 
 #include "eeptypes.h"
 
@@ -388,6 +593,29 @@ void E2Profile::SetI2CPageWrite(int page_write)
 }
 
 
+//Cap to the page size of the device table, for same-named parts with
+// smaller pages. 0 (default) means use the table.
+int E2Profile::GetI2CPageWriteLimit()
+{
+	int rval = s->value("I2CPageWriteLimit", 0).toInt();
+
+	return (rval > 0) ? rval : 0;
+}
+
+
+void E2Profile::SetI2CPageWriteLimit(int page_write)
+{
+	if (page_write > 0)
+	{
+		s->setValue("I2CPageWriteLimit", QString::number(page_write));
+	}
+	else
+	{
+		s->remove("I2CPageWriteLimit");
+	}
+}
+
+
 int E2Profile::GetSPIPageWrite()
 {
 	QString sp = s->value("BigSPIPageWrite", "16").toString();
@@ -476,6 +704,11 @@ int E2Profile::GetI2CSpeed()
 
 void E2Profile::SetI2CSpeed(int speed)
 {
+	if (speed != GetI2CSpeed())
+	{
+		ClearI2CBestDelay();    //learned with the old speed
+	}
+
 	if (speed == TURBO)
 	{
 		s->setValue("I2CBusSpeed", "TURBO");
@@ -2276,6 +2509,327 @@ void E2Profile::SetGpioPinDataOut(int pin)
 	s->setValue("GpioPinDataOut", QString::number(pin));
 }
 
+//GPIO character device used by the "Linux GPIO Chip" interface
+QString E2Profile::GetGpioChipDev()
+{
+	return s->value("GpioChipDev", "/dev/gpiochip0").toString();
+}
+
+void E2Profile::SetGpioChipDev(const QString &name)
+{
+	s->setValue("GpioChipDev", name);
+}
+
+//GPIO register map used by the "Linux GPIO MMap" interface
+QString E2Profile::GetGpioMemSoc()
+{
+	return s->value("GpioMemSoc", "bcm2835").toString();
+}
+
+void E2Profile::SetGpioMemSoc(const QString &soc)
+{
+	s->setValue("GpioMemSoc", soc);
+}
+
+//Target model emulated by the "Virtual Target" interface
+QString E2Profile::GetVirtualTarget()
+{
+	return s->value("VirtualTarget", "24c16").toString();
+}
+
+void E2Profile::SetVirtualTarget(const QString &model)
+{
+	s->setValue("VirtualTarget", model);
+}
+
+//Write page size of the virtual target, -1 for the default of the model
+int E2Profile::GetVirtualPageSize()
+{
+	QString sp = s->value("VirtualPageSize", "-1").toString();
+	int rval = -1;
+
+	if (sp.length())
+	{
+		rval = sp.toInt();
+	}
+
+	return rval;
+}
+
+void E2Profile::SetVirtualPageSize(int size)
+{
+	s->setValue("VirtualPageSize", QString::number(size));
+}
+
+//Write cycle time (usec) of the virtual target, -1 for the default of the model
+int E2Profile::GetVirtualWriteTime()
+{
+	QString sp = s->value("VirtualWriteTime", "-1").toString();
+	int rval = -1;
+
+	if (sp.length())
+	{
+		rval = sp.toInt();
+	}
+
+	return rval;
+}
+
+void E2Profile::SetVirtualWriteTime(int usec)
+{
+	s->setValue("VirtualWriteTime", QString::number(usec));
+}
+
+//Run the virtual target on a virtual clock (delays return at once)
+bool E2Profile::GetVirtualClock()
+{
+	QString sp = s->value("VirtualClock", "").toString();
+
+	if (sp.length() && (sp == "NO"))
+	{
+		return false;
+	}
+	else
+	{
+		return true;
+	}
+}
+
+void E2Profile::SetVirtualClock(bool enabled)
+{
+	if (enabled)
+	{
+		s->setValue("VirtualClock", "YES");
+	}
+	else
+	{
+		s->setValue("VirtualClock", "NO");
+	}
+}
+
+bool E2Profile::GetDeltaWrite()
+{
+	QString sp = s->value("DeltaWrite", "").toString();
+
+	if (sp.length() && (sp == "YES"))
+	{
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+void E2Profile::SetDeltaWrite(bool enabled)
+{
+	if (enabled)
+	{
+		s->setValue("DeltaWrite", "YES");
+	}
+	else
+	{
+		s->setValue("DeltaWrite", "NO");
+	}
+}
+
+//Write and verify only the pages populated by a HEX or S-record file
+bool E2Profile::GetSparseWrite()
+{
+	QString sp = s->value("SparseWrite", "").toString();
+
+	if (sp.length() && (sp == "YES"))
+	{
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+void E2Profile::SetSparseWrite(bool enabled)
+{
+	if (enabled)
+	{
+		s->setValue("SparseWrite", "YES");
+	}
+	else
+	{
+		s->setValue("SparseWrite", "NO");
+	}
+}
+
+//Write cycle time (usec) learned by the polling scheduler, 0 if unknown
+int E2Profile::GetWriteCycleTime(long type, int slot)
+{
+	QString key = QString("WriteCycle/%1-%2").arg(type, 0, 16).arg(slot);
+	int rval = s->value(key, 0).toInt();
+
+	return (rval > 0) ? rval : 0;
+}
+
+void E2Profile::SetWriteCycleTime(long type, int slot, int usec)
+{
+	QString key = QString("WriteCycle/%1-%2").arg(type, 0, 16).arg(slot);
+
+	s->setValue(key, usec);
+}
+
+bool E2Profile::GetMicrowireSeqRead()
+{
+	QString sp = s->value("MicrowireSeqRead", "").toString();
+
+	if (sp.length() && (sp == "NO"))
+	{
+		return false;
+	}
+	else
+	{
+		return true;
+	}
+}
+
+void E2Profile::SetMicrowireSeqRead(bool enabled)
+{
+	if (enabled)
+	{
+		s->setValue("MicrowireSeqRead", "YES");
+	}
+	else
+	{
+		s->setValue("MicrowireSeqRead", "NO");
+	}
+}
+
+//Max bytes read in a single I2C transaction, 0 for no limit
+long E2Profile::GetI2CMaxBurst()
+{
+	long rval = s->value("I2CMaxBurst", "0").toString().toLong();
+
+	return (rval > 0) ? rval : 0;
+}
+
+void E2Profile::SetI2CMaxBurst(long len)
+{
+	if (len >= 0)
+	{
+		s->setValue("I2CMaxBurst", QString::number(len));
+	}
+}
+
+bool E2Profile::GetI2CAdaptiveSpeed()
+{
+	QString sp = s->value("I2CAdaptiveSpeed", "").toString();
+
+	if (sp.length() && (sp == "YES"))
+	{
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+void E2Profile::SetI2CAdaptiveSpeed(bool enabled)
+{
+	if (enabled)
+	{
+		s->setValue("I2CAdaptiveSpeed", "YES");
+	}
+	else
+	{
+		s->setValue("I2CAdaptiveSpeed", "NO");
+	}
+}
+
+//Stable I2C delay found for a device type on an interface, -1 if not
+// measured yet. It belongs to the I2CBusSpeed it was measured with.
+int E2Profile::GetI2CBestDelay(int interf, long type)
+{
+	QString key = QString("I2CSpeed/%1-%2-%3").arg(interf).arg(GetI2CSpeed()).arg(type, 0, 16);
+
+	return s->value(key, -1).toInt();
+}
+
+void E2Profile::SetI2CBestDelay(int interf, long type, int delay)
+{
+	QString key = QString("I2CSpeed/%1-%2-%3").arg(interf).arg(GetI2CSpeed()).arg(type, 0, 16);
+
+	if (delay < 0)
+	{
+		s->remove(key);
+	}
+	else
+	{
+		s->setValue(key, delay);
+	}
+}
+
+//Forget all the learned I2C delays, they are measured again
+void E2Profile::ClearI2CBestDelay()
+{
+	s->remove("I2CSpeed");
+}
+
+//SPI timing from the device datasheet instead of the SPI speed setting,
+// enabled per programmer interface
+bool E2Profile::GetSPIMinTiming(int interf)
+{
+	QString key = QString("SPIMinTiming/%1").arg(interf);
+	QString sp = s->value(key, "").toString();
+
+	if (sp.length() && (sp == "YES"))
+	{
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+void E2Profile::SetSPIMinTiming(int interf, bool enabled)
+{
+	QString key = QString("SPIMinTiming/%1").arg(interf);
+
+	if (enabled)
+	{
+		s->setValue(key, "YES");
+	}
+	else
+	{
+		s->setValue(key, "NO");
+	}
+}
+
+bool E2Profile::GetProgThreadRealTime()
+{
+	QString sp = s->value("ProgThreadRealTime", "").toString();
+
+	if (sp.length() && (sp == "YES"))
+	{
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+void E2Profile::SetProgThreadRealTime(bool enabled)
+{
+	if (enabled)
+	{
+		s->setValue("ProgThreadRealTime", "YES");
+	}
+	else
+	{
+		s->setValue("ProgThreadRealTime", "NO");
+	}
+}
+
 bool E2Profile::GetEditBufferEnabled()
 {
 	return !(s->value("Editor/ReadOnlyMode", false).toBool());
@@ -29,6 +29,9 @@
 
 #include <QPrinter>
 #include <QSettings>
+#include <QMutex>
+#include <QHash>
+#include <QVariant>
 #include "types.h"
 #include "globals.h"
 
@@ -80,6 +83,49 @@ enum
 
 #define STRBUFSIZE      256
 
+//Timing calibration of a machine, see Wait::Calibrate()
+struct TimingProfile
+{
+	int hwtimer;            //1 if the clock engine is usable
+	int bogokips;           //delay loop iterations per msec
+	long clock_overhead;    //clock read cost (nsec)
+	long sleep_slack;       //sleep overshoot (nsec)
+};
+
+//QSettings front end. While frozen the values are served from a copy
+// taken on the GUI thread, and the changes are kept until Thaw() stores
+// them, so that the programming thread never uses QSettings
+class E2Settings
+{
+  public:
+	E2Settings(const QString &name);
+
+	QVariant value(const QString &key, const QVariant &def = QVariant());
+	void setValue(const QString &key, const QVariant &val);
+	void remove(const QString &key);
+	void beginGroup(const QString &name);
+	void endGroup();
+	void sync();
+	QString fileName() const
+	{
+		return settings.fileName();
+	}
+
+	void Freeze();
+	void Thaw();
+
+  private:
+	static bool InGroup(const QString &key, const QString &group);
+	void Forget(QHash<QString, QVariant> &h, const QString &key);
+
+	QSettings settings;
+	QMutex mtx;
+	bool frozen;
+	QString prefix;                         //beginGroup() while frozen
+	QHash<QString, QVariant> cache;         //values at Freeze()
+	QHash<QString, QVariant> changed;       //setValue() while frozen
+	QStringList removed;                    //remove() while frozen
+};
 
 class E2Profile
 {
@@ -96,6 +142,10 @@ class E2Profile
 	static int GetBogoMips();
 	static void SetBogoMips(int value);
 
+	//Timing profiles are kept per CPU signature (model, governor, clock source)
+	static bool GetTimingProfile(const QString &signature, TimingProfile &prof);
+	static void SetTimingProfile(const QString &signature, const TimingProfile &prof);
+
 	static long GetLastDevType();
 	static void SetLastDevType(long devtype);
 
@@ -114,6 +164,8 @@ class E2Profile
 
 	static int GetI2CPageWrite();
 	static void SetI2CPageWrite(int page_write = 1);
+	static int GetI2CPageWriteLimit();
+	static void SetI2CPageWriteLimit(int page_write = 0);
 
 	static int GetI2CBaseAddr();
 	static void SetI2CBaseAddr(int base_addr = 0xA0);
@@ -272,12 +324,57 @@ class E2Profile
 	static void SetGpioPinDataIn(int pin);
 	static void SetGpioPinDataOut(int pin);
 
+	static QString GetGpioChipDev();
+	static void SetGpioChipDev(const QString &name);
+
+	static QString GetGpioMemSoc();
+	static void SetGpioMemSoc(const QString &soc);
+
+	static QString GetVirtualTarget();
+	static void SetVirtualTarget(const QString &model);
+	static int GetVirtualPageSize();
+	static void SetVirtualPageSize(int size);
+	static int GetVirtualWriteTime();
+	static void SetVirtualWriteTime(int usec);
+	static bool GetVirtualClock();
+	static void SetVirtualClock(bool enabled);
+	static bool GetDeltaWrite();
+	static void SetDeltaWrite(bool enabled);
+	static bool GetSparseWrite();
+	static void SetSparseWrite(bool enabled);
+	static int GetWriteCycleTime(long type, int slot);
+	static void SetWriteCycleTime(long type, int slot, int usec);
+	static bool GetMicrowireSeqRead();
+	static void SetMicrowireSeqRead(bool enabled);
+	static long GetI2CMaxBurst();
+	static void SetI2CMaxBurst(long len);
+	static bool GetI2CAdaptiveSpeed();
+	static void SetI2CAdaptiveSpeed(bool enabled);
+	static int GetI2CBestDelay(int interf, long type);
+	static void SetI2CBestDelay(int interf, long type, int delay);
+	static void ClearI2CBestDelay();
+	static bool GetSPIMinTiming(int interf);
+	static void SetSPIMinTiming(int interf, bool enabled);
+	static bool GetProgThreadRealTime();
+	static void SetProgThreadRealTime(bool enabled);
+
 	static bool GetEditBufferEnabled();
 	static void SetEditBufferEnabled(bool enable);
 
+	//The programming thread must not touch QSettings while the GUI
+	// thread runs: it works on a copy that is written back afterwards
+	static void BeginWorker()
+	{
+		s->Freeze();
+	}
+	static void EndWorker()
+	{
+		s->Thaw();
+	}
+
   protected:    //--------------------------------------- protected
 	static void SetLastFiles(const QStringList &l);
-	static QSettings *s;
+	static E2Settings *s;
 
   private:              //--------------------------------------- private
 //	static QString filename;       //name of .INI file
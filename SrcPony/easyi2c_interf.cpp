@@ -112,14 +112,11 @@ void EasyI2CInterface::Close()
 
 void EasyI2CInterface::SetDataOut(int sda)
 {
-	qDebug() << "EasyI2CInterface::SetDataOut(" << sda << ") *** Inst=" << IsInstalled();
+	qDebugEdge() << "EasyI2CInterface::SetDataOut(" << sda << ") *** Inst=" << IsInstalled();
 
 	if (IsInstalled())
 	{
-		if ((cmdWin->GetPolarity() & DOUTINV) != 0)
-		{
-			sda = !sda;
-		}
+		sda = DataOutLevel(sda);
 
 		//The EasyI2C interface is inverting by default
 		OutDataMask(WF_SDA, sda ? 0 : 1);
@@ -128,14 +125,11 @@ void EasyI2CInterface::SetDataOut(int sda)
 
 void EasyI2CInterface::SetClock(int scl)
 {
-	qDebug() << "EasyI2CInterface::SetClock(" << scl << ") *** Inst=" << IsInstalled();
+	qDebugEdge() << "EasyI2CInterface::SetClock(" << scl << ") *** Inst=" << IsInstalled();
 
 	if (IsInstalled())
 	{
-		if ((cmdWin->GetPolarity() & CLOCKINV) != 0)
-		{
-			scl = !scl;
-		}
+		scl = ClockLevel(scl);
 
 		//The EasyI2C interface is inverting by default
 		OutDataMask(WF_SCL, scl ? 0 : 1);
@@ -144,29 +138,28 @@ void EasyI2CInterface::SetClock(int scl)
 
 void EasyI2CInterface::SetClockData()
 {
-	qDebug() << "EasyI2CInterface::SetClockData() *** Inst=" << IsInstalled();
+	qDebugEdge() << "EasyI2CInterface::SetClockData() *** Inst=" << IsInstalled();
 
 	if (IsInstalled())
 	{
-		int control     = cmdWin->GetPolarity();
 		uint8_t cpreg = GetLastData();
 
-		if (control & CLOCKINV)
+		if (ClockLevel(1))
 		{
-			cpreg |= WF_SCL;
+			cpreg &= ~WF_SCL;
 		}
 		else
 		{
-			cpreg &= ~WF_SCL;
+			cpreg |= WF_SCL;
 		}
 
-		if (control & DOUTINV)
+		if (DataOutLevel(1))
 		{
-			cpreg |= WF_SDA;
+			cpreg &= ~WF_SDA;
 		}
 		else
 		{
-			cpreg &= ~WF_SDA;
+			cpreg |= WF_SDA;
 		}
 
 		OutDataPort(cpreg);
@@ -175,18 +168,11 @@ void EasyI2CInterface::SetClockData()
 
 int EasyI2CInterface::GetDataIn()
 {
-	qDebug() << "EasyI2CInterface::GetDataIn() *** Inst=" << IsInstalled();
+	qDebugEdge() << "EasyI2CInterface::GetDataIn() *** Inst=" << IsInstalled();
 
 	if (IsInstalled())
 	{
-		if (cmdWin->GetPolarity() & DININV)
-		{
-			return !(InDataPort() & RF_SDA);
-		}
-		else
-		{
-			return InDataPort() & RF_SDA;
-		}
+		return DataInLevel(InDataPort() & RF_SDA);
 	}
 	else
 	{
@@ -196,7 +182,7 @@ int EasyI2CInterface::GetDataIn()
 
 int EasyI2CInterface::GetClock()
 {
-	qDebug() << "EasyI2CInterface::GetClock() *** Inst=" << IsInstalled();
+	qDebugEdge() << "EasyI2CInterface::GetClock() *** Inst=" << IsInstalled();
 
 	if (IsInstalled())
 	{
@@ -216,10 +202,7 @@ int EasyI2CInterface::IsClockDataUP()
 		int sda = val & RF_SDA;
 		int scl = val & RF_SCL;
 
-		if (cmdWin->GetPolarity() & DININV)
-		{
-			sda = !sda;
-		}
+		sda = DataInLevel(sda);
 
 		return (sda && scl);
 	}
@@ -237,10 +220,7 @@ int EasyI2CInterface::IsClockDataDOWN()
 		int sda = val & RF_SDA;
 		int scl = val & RF_SCL;
 
-		if (cmdWin->GetPolarity() & DININV)
-		{
-			sda = !sda;
-		}
+		sda = DataInLevel(sda);
 
 		return (!sda && !scl);
 	}
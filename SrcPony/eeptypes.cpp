@@ -37,14 +37,24 @@
 //AutoTag
 //Device type description vectors
 
+//SPI SCK minimum times of the devices that program through SPI.
+// AVR: > 2 CPU cycles, at the 1MHz of the internal RC oscillator as
+//  shipped; the parts running from a crystal have no timing.
+// AT89S: a 12MHz crystal is assumed.
+// 25xxx: tWH, tWL of the 1.8V grades.
+#define SCK_AVR_1MHZ    2500, 2500
+#define SCK_AT89_X40    1700, 1700          //SCK < fXTAL / 40
+#define SCK_AT89_X16    700, 700            //tSHSL, tSLSH 8 tCLCL
+#define SCK_25XXX       1000, 1000
+
 
 static QVector<chipInfo> const eep24xx_map =
 {
 	{ "24XX Auto", E2400, AUTOSIZE_ID / 256, -1, -1, -1 },
-	{"2402", E2402, 1, -1, -1, -1},
-	{"2404", E2404, 2, -1, -1, -1},
-	{"2408", E2408, 4, -1, -1, -1},
-	{"2416", E2416, 8, -1, -1, -1}
+	{"2402", E2402, 1, -1, 8, -1},
+	{"2404", E2404, 2, -1, 16, -1},
+	{"2408", E2408, 4, -1, 16, -1},
+	{"2416", E2416, 8, -1, 16, -1}
 };
 
 
@@ -66,12 +76,14 @@ static QVector<chipInfo> const eep24xx1B_map =
 static QVector<chipInfo> const eep24xx2_map =
 {
 	//      "Auto",
-	{"24E16", E24E16, 8, -1, -1, -1},
-	{"2432", E2432, 16, -1, -1, -1},
-	{"2464/2465", E2464, 32, -1, -1, -1},
-	{"24128", E24128, 64, -1, -1, -1},
-	{"24256", E24256, 128, -1, -1, -1},
-	{"24512", E24512, 256, -1, -1, -1}
+	{"24E16", E24E16, 8, -1, 16, -1},
+	{"2432", E2432, 16, -1, 32, -1},
+	{"2464/2465", E2464, 32, -1, 32, -1},
+	{"24128", E24128, 64, -1, 64, -1},
+	{"24256", E24256, 128, -1, 64, -1},
+	{"24512", E24512, 256, -1, 128, -1},
+	{"24M01", E241024, 512, -1, 256, -1},
+	{"24M02", E242048, 1024, -1, 256, -1}
 };
 
 
@@ -90,76 +102,76 @@ static QVector<chipInfo> const eepAt90s_map =
 	{"AT90S2313", AT90S2313, (KB(2) + 128), KB(2), 0, -1},
 	{"AT90S2323", AT90S2323, (KB(2) + 128), KB(2), 0, -1},
 	{"AT90S2333", AT90S2333, (KB(2) + 128), KB(2), 0, -1},
-	{"AT90S2343", AT90S2343, (KB(2) + 128), KB(2), 0, -1},
+	{"AT90S2343", AT90S2343, (KB(2) + 128), KB(2), 0, -1, 0, 0, SCK_AVR_1MHZ},
 	{"AT90S4414", AT90S4414, (KB(4) + 256), KB(4), 0, -1},
 	{"AT90S4433", AT90S4433, (KB(4) + 256), KB(4), 0, -1},
 	{"AT90S4434", AT90S4434, (KB(4) + 256), KB(4), 0, -1},
 	{"AT90S8515", AT90S8515, (KB(8) + 512), KB(8), 0, -1},
 	{"AT90C8534", AT90S8534, (KB(8) + 512), KB(8), 0, -1},
 	{"AT90S8535", AT90S8535, (KB(8) + 512), KB(8), 0, -1},
-	{"AT90CAN32", AT90CAN32, (KB(32) + KB(1)), KB(32), 128, -1},
-	{"AT90CAN64", AT90CAN64, (KB(64) + KB(2)), KB(64), 256, -1},
-	{"AT90CAN128", AT90CAN128, (KB(128) + KB(4)), KB(128), 256, -1},
-
-	{"ATmega8515", ATmega8515, (KB(8) + 512), KB(8), 64, -1 },
-	{"ATmega8535", ATmega8535, (KB(8) + 512), KB(8), 64, -1 },
-	{"ATmega48", ATmega48, (KB(4) + 256), KB(4), 64, -1},
-	{"ATmega8", ATmega8, (KB(8) + 512), KB(8), 64, -1},
-	{"ATmega88", ATmega88, (KB(8) + 512), KB(8),  64, -1},
-	{"ATmega16", ATmega16, (KB(16) + 512), KB(16), 128, -1},
+	{"AT90CAN32", AT90CAN32, (KB(32) + KB(1)), KB(32), 128, -1, AVR_RDYBSY, 8, SCK_AVR_1MHZ},
+	{"AT90CAN64", AT90CAN64, (KB(64) + KB(2)), KB(64), 256, -1, AVR_RDYBSY, 8, SCK_AVR_1MHZ},
+	{"AT90CAN128", AT90CAN128, (KB(128) + KB(4)), KB(128), 256, -1, AVR_RDYBSY, 8, SCK_AVR_1MHZ},
+
+	{"ATmega8515", ATmega8515, (KB(8) + 512), KB(8), 64, -1, 0, 0, SCK_AVR_1MHZ},
+	{"ATmega8535", ATmega8535, (KB(8) + 512), KB(8), 64, -1, 0, 0, SCK_AVR_1MHZ},
+	{"ATmega48", ATmega48, (KB(4) + 256), KB(4), 64, -1, AVR_RDYBSY, 4, SCK_AVR_1MHZ},
+	{"ATmega8", ATmega8, (KB(8) + 512), KB(8), 64, -1, 0, 0, SCK_AVR_1MHZ},
+	{"ATmega88", ATmega88, (KB(8) + 512), KB(8),  64, -1, AVR_RDYBSY, 4, SCK_AVR_1MHZ},
+	{"ATmega16", ATmega16, (KB(16) + 512), KB(16), 128, -1, 0, 0, SCK_AVR_1MHZ},
 	{"ATmega161", ATmega161, (KB(16) + 512), KB(16), 128, -1},
-	{"ATmega162", ATmega162, (KB(16) + 512), KB(16), 128, -1},
-	{"ATmega163", ATmega163, (KB(16) + 512), KB(16), 128, -1},
-	{"ATmega164", ATmega164, (KB(16) + 512), KB(16), 128, -1},
-	{"ATmega168", ATmega168, (KB(16) + 512), KB(16), 128, -1},
-	{"ATmega169", ATmega169, (KB(16) + 512), KB(16), 128, -1},
-	{"ATmega32", ATmega32, (KB(32) + KB(1)), KB(32), 128, -1},
-
-	{"ATmega323", ATmega323, (KB(32) + KB(1)), KB(32), 128, -1},
-	{"ATmega324", ATmega324, (KB(32) + KB(1)), KB(32), 128, -1},
-	{"ATmega328", ATmega328, (KB(32) + KB(1)), KB(32), 128, -1}, // new (RG 22.06.2012)
+	{"ATmega162", ATmega162, (KB(16) + 512), KB(16), 128, -1, 0, 0, SCK_AVR_1MHZ},
+	{"ATmega163", ATmega163, (KB(16) + 512), KB(16), 128, -1, 0, 0, SCK_AVR_1MHZ},
+	{"ATmega164", ATmega164, (KB(16) + 512), KB(16), 128, -1, AVR_RDYBSY, 8, SCK_AVR_1MHZ},
+	{"ATmega168", ATmega168, (KB(16) + 512), KB(16), 128, -1, AVR_RDYBSY, 4, SCK_AVR_1MHZ},
+	{"ATmega169", ATmega169, (KB(16) + 512), KB(16), 128, -1, 0, 0, SCK_AVR_1MHZ},
+	{"ATmega32", ATmega32, (KB(32) + KB(1)), KB(32), 128, -1, 0, 0, SCK_AVR_1MHZ},
+
+	{"ATmega323", ATmega323, (KB(32) + KB(1)), KB(32), 128, -1, 0, 0, SCK_AVR_1MHZ},
+	{"ATmega324", ATmega324, (KB(32) + KB(1)), KB(32), 128, -1, AVR_RDYBSY, 8, SCK_AVR_1MHZ},
+	{"ATmega328", ATmega328, (KB(32) + KB(1)), KB(32), 128, -1, AVR_RDYBSY, 4, SCK_AVR_1MHZ}, // new (RG 22.06.2012)
 	{"ATmega603", ATmega603, (KB(64) + KB(2)), KB(64), 256, -1},
 	{"ATmega103", ATmega103, (KB(128) + KB(4)), KB(128), 256, -1},
-	{"ATmega64", ATmega64, (KB(64) + KB(2)), KB(64), 256, -1},
-	{"ATmega640", ATmega640, (KB(64) + KB(4)), KB(64), 256, -1},
-	{"ATmega644", ATmega644, (KB(64) + KB(2)), KB(64), 256, -1},
-	{"ATmega128", ATmega128, (KB(128) + KB(4)), KB(128), 256, -1},
-	{"ATmega1280", ATmega1280, (KB(128) + KB(4)), KB(128), 256, -1},
-	{"ATmega1281", ATmega1281, (KB(128) + KB(4)), KB(128), 256, -1},
-	{"ATmega2560", ATmega2560, (KB(256) + KB(4)), KB(256), 256, -1},
-	{"ATmega2561", ATmega2561, (KB(256) + KB(4)), KB(256), 256, -1},
-
-	{"ATtiny12", ATtiny12, (KB(1) + 64), KB(1), 0, -1},
-	{"ATtiny13", ATtiny13, (KB(1) + 64), KB(1), 32, -1},
-	{"ATtiny15", ATtiny15, (KB(1) + 64), KB(1), 0, -1},
-	{"ATtiny22", ATtiny22, (KB(2) + 128), KB(2), 0, -1},
-	{"ATtiny25", ATtiny25, (KB(2) + 128), KB(2), 32, -1},
-	{"ATtiny26", ATtiny26, (KB(2) + 128), KB(2), 32, -1},
-	{"ATtiny261", ATtiny261, (KB(2) + 128), KB(2), 32, -1},
+	{"ATmega64", ATmega64, (KB(64) + KB(2)), KB(64), 256, -1, 0, 0, SCK_AVR_1MHZ},
+	{"ATmega640", ATmega640, (KB(64) + KB(4)), KB(64), 256, -1, AVR_RDYBSY, 8, SCK_AVR_1MHZ},
+	{"ATmega644", ATmega644, (KB(64) + KB(2)), KB(64), 256, -1, AVR_RDYBSY, 8, SCK_AVR_1MHZ},
+	{"ATmega128", ATmega128, (KB(128) + KB(4)), KB(128), 256, -1, 0, 0, SCK_AVR_1MHZ},
+	{"ATmega1280", ATmega1280, (KB(128) + KB(4)), KB(128), 256, -1, AVR_RDYBSY, 8, SCK_AVR_1MHZ},
+	{"ATmega1281", ATmega1281, (KB(128) + KB(4)), KB(128), 256, -1, AVR_RDYBSY, 8, SCK_AVR_1MHZ},
+	{"ATmega2560", ATmega2560, (KB(256) + KB(4)), KB(256), 256, -1, AVR_RDYBSY, 8, SCK_AVR_1MHZ},
+	{"ATmega2561", ATmega2561, (KB(256) + KB(4)), KB(256), 256, -1, AVR_RDYBSY, 8, SCK_AVR_1MHZ},
+
+	{"ATtiny12", ATtiny12, (KB(1) + 64), KB(1), 0, -1, 0, 0, SCK_AVR_1MHZ},
+	{"ATtiny13", ATtiny13, (KB(1) + 64), KB(1), 32, -1, AVR_RDYBSY, 4, SCK_AVR_1MHZ},
+	{"ATtiny15", ATtiny15, (KB(1) + 64), KB(1), 0, -1, 0, 0, SCK_AVR_1MHZ},
+	{"ATtiny22", ATtiny22, (KB(2) + 128), KB(2), 0, -1, 0, 0, SCK_AVR_1MHZ},
+	{"ATtiny25", ATtiny25, (KB(2) + 128), KB(2), 32, -1, AVR_RDYBSY, 4, SCK_AVR_1MHZ},
+	{"ATtiny26", ATtiny26, (KB(2) + 128), KB(2), 32, -1, 0, 0, SCK_AVR_1MHZ},
+	{"ATtiny261", ATtiny261, (KB(2) + 128), KB(2), 32, -1, AVR_RDYBSY, 4, SCK_AVR_1MHZ},
 	//      {"ATtiny28", ATtiny28, },
-	{"ATtiny2313", ATtiny2313, (KB(2) + 128), KB(2), 32, -1},
-	{"ATtiny45", ATtiny45, (KB(4) + 256), KB(4), 64,  -1},
-	{"ATtiny461", ATtiny461, (KB(4) + 256), KB(4), 64, -1},
-	{"ATtiny85", ATtiny85, (KB(8) + 512), KB(8), 64, -1},
-	{"ATtiny861", ATtiny861, (KB(8) + 512), KB(8), 64, -1}
+	{"ATtiny2313", ATtiny2313, (KB(2) + 128), KB(2), 32, -1, AVR_RDYBSY, 4, SCK_AVR_1MHZ},
+	{"ATtiny45", ATtiny45, (KB(4) + 256), KB(4), 64,  -1, AVR_RDYBSY, 4, SCK_AVR_1MHZ},
+	{"ATtiny461", ATtiny461, (KB(4) + 256), KB(4), 64, -1, AVR_RDYBSY, 4, SCK_AVR_1MHZ},
+	{"ATtiny85", ATtiny85, (KB(8) + 512), KB(8), 64, -1, AVR_RDYBSY, 4, SCK_AVR_1MHZ},
+	{"ATtiny861", ATtiny861, (KB(8) + 512), KB(8), 64, -1, AVR_RDYBSY, 4, SCK_AVR_1MHZ}
 };
 
 
 static QVector<chipInfo> const eepAt89s_map =
 {
 	//      "AT89SXX Auto", AT89S0000
-	{"AT89S8252", AT89S8252, KB(8) + KB(2), KB(8), 0, -1 },
-	{"AT89S8253", AT89S8253, KB(12) + KB(2), KB(12), 64, 1 },
-	{"AT89S51", AT89S51, KB(4), KB(4), 256, -1 },
-	{"AT89S52", AT89S52, KB(8), KB(8), 256, -1 },
-	{"AT89S53", AT89S53, KB(12), KB(12), 0, -1 }
+	{"AT89S8252", AT89S8252, KB(8) + KB(2), KB(8), 0, -1, 0, 0, SCK_AT89_X40},
+	{"AT89S8253", AT89S8253, KB(12) + KB(2), KB(12), 64, 1, 0, 0, SCK_AT89_X16},
+	{"AT89S51", AT89S51, KB(4), KB(4), 256, -1, 0, 0, SCK_AT89_X16},
+	{"AT89S52", AT89S52, KB(8), KB(8), 256, -1, 0, 0, SCK_AT89_X16},
+	{"AT89S53", AT89S53, KB(12), KB(12), 0, -1, 0, 0, SCK_AT89_X40}
 };
 
 
 static QVector<chipInfo> const eep93x6_map =
 {
 	//      "93XX Auto", E9300
-	{"9306", E9306, 16, -1, -1, 64},
+	{"9306", E9306, 16, -1, -1, 64, MW_WORDREAD},
 	{"9346", E9346, 64, -1, -1, 64},
 	{"9356", E9356, 128, -1, -1, 256},
 	{"9357", E9357, 128, -1, -1, 128},
@@ -172,7 +184,7 @@ static QVector<chipInfo> const eep93x6_map =
 static QVector<chipInfo> const eep93xx8_map =
 {
 	//      "93XX Auto",
-	{"9306", E9306_8, 32, -1, -1, 128},
+	{"9306", E9306_8, 32, -1, -1, 128, MW_WORDREAD},
 	{"9346", E9346_8, 128, -1, -1, 128},
 	{"9356", E9356_8, 256, -1, -1, 512},
 	{"9357", E9357_8, 256, -1, -1, 256},
@@ -232,21 +244,21 @@ static QVector<chipInfo> const eepPic125_map =
 static QVector<chipInfo> const eep250xx_map =
 {
 	//      "250X0 Auto",
-	{"25010", E25010, 128, -1, -1, -1},
-	{"25020", E25020, 256, -1, -1, -1},
-	{"25040", E25040, 512, -1, -1, -1}
+	{"25010", E25010, 128, -1, -1, -1, 0, 0, SCK_25XXX},
+	{"25020", E25020, 256, -1, -1, -1, 0, 0, SCK_25XXX},
+	{"25040", E25040, 512, -1, -1, -1, 0, 0, SCK_25XXX}
 };
 
 
 static QVector<chipInfo> const eep25xxx_map =
 {
 	//      "25XXX Auto",E25XX0
-	{"25080", E25080, KB(1), -1, -1, -1},
-	{"25160", E25160, KB(2), -1, -1, -1},
-	{"25320", E25320, KB(4), -1, -1, -1},
-	{"2564X/95640", E25640, KB(8), -1, -1, -1},
-	{"25128", E25128, KB(16), -1, -1, -1},
-	{"25256", E25256, KB(32), -1, -1, -1}
+	{"25080", E25080, KB(1), -1, -1, -1, 0, 0, SCK_25XXX},
+	{"25160", E25160, KB(2), -1, -1, -1, 0, 0, SCK_25XXX},
+	{"25320", E25320, KB(4), -1, -1, -1, 0, 0, SCK_25XXX},
+	{"2564X/95640", E25640, KB(8), -1, -1, -1, 0, 0, SCK_25XXX},
+	{"25128", E25128, KB(16), -1, -1, -1, 0, 0, SCK_25XXX},
+	{"25256", E25256, KB(32), -1, -1, -1, 0, 0, SCK_25XXX}
 };
 
 
@@ -611,6 +623,68 @@ int GetEEPTypeWPageSize(unsigned long type)
 }
 
 
+int GetEEPTypeFlags(unsigned long type)
+{
+	int pritype = GetE2PPriType(type);
+	int subtype = GetE2PSubType(type);
+
+	QVector<chipInfo> mp = GetMap(pritype);
+
+	if (mp.count() == 0)
+	{
+		return 0;
+	}
+
+	chipInfo i = GetChipInfo(mp, subtype);
+
+	return i.flags;
+}
+
+int GetEEPTypeEPageSize(unsigned long type)
+{
+	int pritype = GetE2PPriType(type);
+	int subtype = GetE2PSubType(type);
+
+	QVector<chipInfo> mp = GetMap(pritype);
+
+	if (mp.count() == 0)
+	{
+		return 0;
+	}
+
+	chipInfo i = GetChipInfo(mp, subtype);
+
+	return i.epgsz;
+}
+
+//Minimum SCK high and low time of the device, false if not known
+bool GetEEPTypeSPITiming(unsigned long type, int &high_ns, int &low_ns)
+{
+	int pritype = GetE2PPriType(type);
+	int subtype = GetE2PSubType(type);
+
+	QVector<chipInfo> mp = GetMap(pritype);
+
+	high_ns = low_ns = 0;
+
+	if (mp.count() == 0)
+	{
+		return false;
+	}
+
+	chipInfo i = GetChipInfo(mp, subtype);
+
+	if (i.sckhi <= 0 || i.scklo <= 0)
+	{
+		return false;
+	}
+
+	high_ns = i.sckhi;
+	low_ns = i.scklo;
+
+	return true;
+}
+
 QVector<chipInfo> GetEEPSubTypeVector(int type)
 {
 	QVector<chipInfo> mp = GetMap(type);
@@ -52,6 +52,8 @@
 #define E24128          0x020040
 #define E24256          0x020080
 #define E24512          0x020100
+#define E241024         0x020200
+#define E242048         0x020400
 
 #define AT90SXX         0x03
 // Sub types
@@ -265,6 +267,10 @@
 
 #define KB(x)   ((x) * 1024)
 
+//chipInfo capability flags
+#define AVR_RDYBSY      0x01    //AVR whose datasheet lists Poll RDY/BSY ($F0), the others use data polling
+#define MW_WORDREAD     0x02    //Microwire without sequential read, one READ per word
+
 
 // EK 2017
 // common structure for chips
@@ -276,6 +282,10 @@ struct chipInfo
 	int  splt;  // split
 	int  wpgsz; // page size
 	int  adrsz; //dimensione dello spazio di indirizzamento in numero di banchi
+	int  flags; //capability flags
+	int  epgsz; //data EEPROM page size
+	int  sckhi; //SPI SCK minimum high time (ns), 0 if unknown
+	int  scklo; //SPI SCK minimum low time (ns)
 };
 
 
@@ -306,6 +316,9 @@ extern long GetEEPTypeFromString(const QString &name);
 
 // extern int GetEEPTypeWPageSize(int pritype, int subtype);
 extern int GetEEPTypeWPageSize(unsigned long type);
+extern int GetEEPTypeFlags(unsigned long type);
+extern int GetEEPTypeEPageSize(unsigned long type);
+extern bool GetEEPTypeSPITiming(unsigned long type, int &high_ns, int &low_ns);
 
 
 #endif
@@ -68,6 +68,20 @@ long FileBuf::GetBufSize() const
 	return awi->GetBufSize();
 }
 
+void FileBuf::SetUsed(uint8_t const *ptr, long len)
+{
+	awi->SetUsed(ptr - awi->GetBufPtr(), len);
+}
+
+//Forget the locations recorded so far (the file is loaded again)
+void FileBuf::ResetUsed()
+{
+	if (awi->HasUsedMap())
+	{
+		awi->StartUsedMap();
+	}
+}
+
 int FileBuf::GetNoOfBlock() const
 {
 	return awi->GetNoOfBlock();
@@ -90,6 +90,8 @@ class FileBuf
 
 	uint8_t *GetBufPtr() const;
 	long GetBufSize() const;
+	void SetUsed(uint8_t const *ptr, long len);        //record the buffer locations loaded
+	void ResetUsed();
 	e2AppWinInfo *GetAWInfo();
 	long GetFileSize(QFile &fh);
 
@@ -68,6 +68,9 @@ enum HInterfaceType
 	DT006_IO,
 	//      JDM_IO,
 	LINUXSYSFS_IO,
+	LINUXGPIOCHIP_IO,
+	LINUXGPIOMEM_IO,
+	VIRTUAL_IO,
 	LAST_HT
 };
 
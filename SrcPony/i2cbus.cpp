@@ -35,6 +35,7 @@
 #include "e2cmdw.h"
 
 #include <QDebug>
+#include <string.h>
 
 
 #ifdef  __linux__
@@ -49,15 +50,22 @@
 #  endif
 #endif
 
-#define SCLTIMEOUT      900     // enable SCL check and timing (for slaves that hold down the SCL line to slow the transfer)
+#define SCLTIMEOUT      900     // enable SCL check and timing (for slaves that hold down the SCL line to slow the transfer), usec
 
 #define BUSYDELAY       100
 #define SDATIMEOUT      200
 
 // Constructor
 I2CBus::I2CBus(BusInterface *ptr)
-	: BusIO(ptr)
+	: BusIO(ptr),
+	  max_burst(0),
+	  scan_busI(0),
+	  scl_count(0),
+	  stretch_count(0),
+	  scl_freq(0)
 {
+	memset(scan_map, 0, sizeof(scan_map));
+	memset(scan_done, 0, sizeof(scan_done));
 	shot_delay = 0;
 }
 
@@ -67,6 +75,28 @@ I2CBus::~I2CBus()
 	Close();
 }
 
+//Wait for SCL to rise: slow pull-up or a slave stretching the clock.
+// The bit timing starts again from the real rising edge.
+int I2CBus::WaitSCLHigh()
+{
+	if (getSCL() == 0)
+	{
+		long long t0 = GetTimestamp();
+
+		while (getSCL() == 0)
+		{
+			if ((GetTimestamp() - t0) / 1000 > SCLTIMEOUT)
+			{
+				return IICERR_SCLCONFLICT;
+			}
+		}
+
+		stretch_count++;
+	}
+
+	return 0;
+}
+
 int I2CBus::CheckBusy()
 {
 	register int count;
@@ -86,19 +116,9 @@ int I2CBus::SendStart()
 	setSCLSDA();
 #ifdef  SCLTIMEOUT
 
-	if (getSCL() == 0)
+	if ((err = WaitSCLHigh()))
 	{
-		int k;
-
-		for (k = SCLTIMEOUT; getSCL() == 0 && k > 0; k--)
-		{
-			WaitUsec(1);
-		}
-
-		if (k == 0)
-		{
-			return IICERR_SCLCONFLICT;
-		}
+		return err;
 	}
 
 #else
@@ -127,20 +147,10 @@ int I2CBus::SendStop()
 	setSCL();
 #ifdef  SCLTIMEOUT
 
-	if (getSCL() == 0)
+	if (WaitSCLHigh())
 	{
-		int k;
-
-		for (k = SCLTIMEOUT; getSCL() == 0 && k > 0; k--)
-		{
-			WaitUsec(1);
-		}
-
-		if (k == 0)
-		{
-			//      qDebug() << "I2CBus::SendStop() *** SCL error";
-			return IICERR_SCLCONFLICT;
-		}
+		//      qDebug() << "I2CBus::SendStop() *** SCL error";
+		return IICERR_SCLCONFLICT;
 	}
 
 #else
@@ -167,26 +177,17 @@ int I2CBus::SendBitMast(int b)
 	bitSDA(b);
 	WaitUsec(shot_delay / 2 + 1);   // tSU;DAT = 250 nsec (tLOW / 2 = 2 usec)
 	setSCL();
+	scl_count++;
 
 	/* Se SCL e` ancora 0 significa che uno Slave sta` rallentando
 	 * il trasferimento, attendi che SCL si rialzi */
-	if (getSCL() == 0)
-	{
 #ifdef  SCLTIMEOUT
-		int k;
-
-		for (k = SCLTIMEOUT; getSCL() == 0 && k > 0; k--)
-		{
-			WaitUsec(1);
-		}
-
-		if (k == 0)
-		{
-			return IICERR_SCLCONFLICT;
-		}
+	if (WaitSCLHigh())
+	{
+		return IICERR_SCLCONFLICT;
+	}
 
 #endif
-	}
 
 	WaitUsec(shot_delay / 2); // tHIGH / 2 = 2 usec
 
@@ -210,26 +211,17 @@ int I2CBus::RecBitMast()
 	setSDA();               // to receive data SDA must be high
 	WaitUsec(shot_delay / 2 + 1);   // tSU;DAT = 250 nsec (tLOW / 2 = 2 usec)
 	setSCL();
+	scl_count++;
 
 	/* Se SCL e` ancora 0 significa che uno Slave sta` rallentando
 	 * il trasferimento, attendi che SCL si rialzi */
-	if (getSCL() == 0)
-	{
 #ifdef  SCLTIMEOUT
-		int k;
-
-		for (k = SCLTIMEOUT; getSCL() == 0 && k > 0; k--)
-		{
-			WaitUsec(1);
-		}
-
-		if (k == 0)
-		{
-			return IICERR_SCLCONFLICT;
-		}
+	if (WaitSCLHigh())
+	{
+		return IICERR_SCLCONFLICT;
+	}
 
 #endif
-	}
 
 	WaitUsec(shot_delay / 2); // tHIGH / 2 = 2 usec
 	b = getSDA();
@@ -381,6 +373,17 @@ void I2CBus::SetDelay()
 		break;
 	}
 
+	//fastest stable speed found for this device by Calibration()
+	if (E2Profile::GetI2CAdaptiveSpeed())
+	{
+		int best = E2Profile::GetI2CBestDelay(E2Profile::GetParInterfType(), GetPollType());
+
+		if (best >= 0)
+		{
+			n = best;
+		}
+	}
+
 	BusIO::SetDelay(n);
 
 	qDebug() << "I2CBus::SetDelay() = " << n;
@@ -569,6 +572,113 @@ fineW:
 	return length - len;
 }
 
+//Start, slave address (write) and the word address MSB first
+int I2CBus::SendWordAddress(int slave, long addr, int addr_bytes)
+{
+	uint8_t index[2];
+	int n = 0;
+
+	if (addr_bytes == 2)
+	{
+		index[n++] = (uint8_t)((addr >> 8) & 0xFF);
+	}
+
+	index[n++] = (uint8_t)(addr & 0xFF);
+
+	if (StartWrite(slave, index, n) != n)
+	{
+		return err_no ? err_no : IICERR_NOTACK;
+	}
+
+	return OK;
+}
+
+long I2CBus::ReadBlock(int slave, long addr, int addr_bytes, uint8_t *data, long length)
+{
+	long len;
+
+	qDebug() << "I2CBus::ReadBlock(" << (hex) << slave << ", " << addr << (dec) << ", " << addr_bytes << ", " << length << ") - IN";
+
+	if (addr_bytes < 1 || addr_bytes > 2 || length <= 0)
+	{
+		err_no = BADPARAM;
+		return 0;
+	}
+
+	for (len = 0; len < length; )
+	{
+		long n = length - len;
+
+		if (max_burst > 0 && n > max_burst)
+		{
+			n = max_burst;
+		}
+
+		if (SendWordAddress(slave, addr + len, addr_bytes) != OK)
+		{
+			break;
+		}
+
+		if (Read(slave, data + len, n) != n)
+		{
+			break;
+		}
+
+		len += n;
+	}
+
+	if (len < length && err_no == IICERR_NOADDRACK)
+	{
+		ForgetScan();
+	}
+
+	qDebug() << "I2CBus::ReadBlock() = " << len << ", err_no = " << err_no << " - OUT";
+
+	return len;
+}
+
+long I2CBus::WriteBlock(int slave, long addr, int addr_bytes, uint8_t const *data, long length)
+{
+	long len = 0;
+
+	qDebug() << "I2CBus::WriteBlock(" << (hex) << slave << ", " << addr << (dec) << ", " << addr_bytes << ", " << length << ") - IN";
+
+	if (addr_bytes < 1 || addr_bytes > 2 || length <= 0 || length > I2C_MAX_PAGE)
+	{
+		err_no = BADPARAM;
+		return 0;
+	}
+
+	if (SendWordAddress(slave, addr, addr_bytes) == OK)
+	{
+		int error = 0;
+
+		while (len < length)
+		{
+			if ((error = SendByteMast(data[len])) != 0)
+			{
+				err_no = error;
+				break;
+			}
+
+			len++;
+		}
+
+		if (error == 0 && Stop())
+		{
+			len = 0;
+		}
+	}
+	else if (err_no == IICERR_NOADDRACK)
+	{
+		ForgetScan();
+	}
+
+	qDebug() << "I2CBus::WriteBlock() = " << len << ", err_no = " << err_no << " - OUT";
+
+	return len;
+}
+
 int I2CBus::Stop(void)
 {
 	qDebug() << "I2CBus::Stop() - IN";
@@ -584,7 +694,11 @@ int I2CBus::Reset(void)
 {
 	qDebug() << "I2CBus::Reset() - IN";
 
+	//a new session, the device in the socket may have been swapped
+	ForgetScan();
+
 	SetDelay();
+	SetMaxBurst(E2Profile::GetI2CMaxBurst());
 
 	uint8_t c;
 	Read(0x00, &c, 0);
@@ -596,6 +710,199 @@ int I2CBus::Reset(void)
 	return OK;
 }
 
+//Address-only write transactions don't start any write cycle.
+//Return 1 if the 7-bit address k acknowledges, 0 if not, < 0 on error
+int I2CBus::ProbeAddress(int k)
+{
+	int rval = Start(k << 1);
+	int found = (rval == OK);
+
+	if (rval != OK && rval != IICERR_NOADDRACK)
+	{
+		Stop();
+		return rval;
+	}
+
+	if (Stop())
+	{
+		return err_no;
+	}
+
+	err_no = 0;
+
+	if (found)
+	{
+		scan_map[k / 8] |= (1 << (k % 8));
+	}
+	else
+	{
+		scan_map[k / 8] &= ~(1 << (k % 8));
+	}
+
+	scan_done[k / 8] |= (1 << (k % 8));
+
+	return found;
+}
+
+//Probe the whole bus in a single pass, return the number of devices found
+int I2CBus::Scan(bool force)
+{
+	qDebug() << "I2CBus::Scan(" << force << ") - IN";
+
+	if (force)
+	{
+		ForgetScan();
+	}
+
+	int count = 0;
+
+	for (int k = 0; k < 128; k++)
+	{
+		int rval = IsPresent(k << 1);
+
+		if (rval < 0)
+		{
+			return rval;
+		}
+
+		count += rval;
+	}
+
+	qDebug() << "I2CBus::Scan() = " << count << " - OUT";
+
+	return count;
+}
+
+//slave is the 8-bit form of the address, the R/W bit is ignored
+int I2CBus::IsPresent(int slave)
+{
+	int k = (slave >> 1) & 0x7F;
+
+	if (scan_busI != busI)
+	{
+		ForgetScan();           //another interface
+		scan_busI = busI;
+	}
+
+	if (!(scan_done[k / 8] & (1 << (k % 8))))
+	{
+		return ProbeAddress(k);
+	}
+
+	return (scan_map[k / 8] & (1 << (k % 8))) ? 1 : 0;
+}
+
+//Delays tried by Calibration(), slowest first
+static const int cal_delay[] = { 1000, 100, 20, 5, 2, 1, 0 };
+
+bool I2CBus::NeedCalibration()
+{
+	return E2Profile::GetI2CAdaptiveSpeed() && E2Profile::GetI2CBestDelay(E2Profile::GetParInterfType(), GetPollType()) < 0;
+}
+
+//Raise the speed one step at a time while the same block reads back
+// equal twice, stop at the first error or mismatch. Only the read timing
+// is checked (not tSU:STO/tBUF of the write cycle), so the step before
+// the fastest good one is kept as margin. The result is stored for the
+// device type and the interface.
+int I2CBus::Calibration(int slave, int addr_bytes)
+{
+	uint8_t ref[I2C_CAL_LEN];
+	uint8_t buf[I2C_CAL_LEN];
+
+	qDebug() << "I2CBus::Calibration(" << (hex) << slave << (dec) << ", " << addr_bytes << ") - IN";
+
+	int best = shot_delay;
+	int safe = shot_delay;
+
+	if (MeasureRead(slave, addr_bytes, ref) != OK)
+	{
+		return err_no;
+	}
+
+	//misread bits of a blank or uniform block still compare equal (SDA
+	// idles high), nothing can be learned: try again with another content
+	int j;
+
+	for (j = 1; j < I2C_CAL_LEN && ref[j] == ref[0]; j++)
+	{
+	}
+
+	if (j == I2C_CAL_LEN)
+	{
+		qDebug() << "I2CBus::Calibration() uniform block, skipped - OUT";
+		return shot_delay;
+	}
+
+	for (unsigned int k = 0; k < sizeof(cal_delay) / sizeof(cal_delay[0]); k++)
+	{
+		if (cal_delay[k] >= best)
+		{
+			continue;
+		}
+
+		BusIO::SetDelay(cal_delay[k]);
+
+		int pass;
+
+		for (pass = 0; pass < 2; pass++)
+		{
+			if (MeasureRead(slave, addr_bytes, buf) != OK || memcmp(ref, buf, I2C_CAL_LEN) != 0)
+			{
+				break;
+			}
+		}
+
+		if (pass < 2)
+		{
+			qDebug() << "I2CBus::Calibration() delay " << cal_delay[k] << " failed";
+			break;
+		}
+
+		safe = best;
+		best = cal_delay[k];
+	}
+
+	//back to one step slower than the fastest good speed and free the bus
+	// from a slave left in the middle of a transfer
+	BusIO::SetDelay(safe);
+	uint8_t c;
+	Read(0x00, &c, 0);
+	setSCLSDA();
+
+	err_no = 0;
+	E2Profile::SetI2CBestDelay(E2Profile::GetParInterfType(), GetPollType(), safe);
+
+	qDebug() << "I2CBus::Calibration() = " << safe << " (fastest " << best << "), " << scl_freq << " Hz - OUT";
+
+	return safe;
+}
+
+//Read the calibration block and measure the SCL frequency achieved
+int I2CBus::MeasureRead(int slave, int addr_bytes, uint8_t *data)
+{
+	scl_count = 0;
+	stretch_count = 0;
+
+	long long t0 = GetTimestamp();
+
+	if (ReadBlock(slave, 0, addr_bytes, data, I2C_CAL_LEN) != I2C_CAL_LEN)
+	{
+		return err_no ? err_no : IICERR_NOTACK;
+	}
+
+	long long dt = GetTimestamp() - t0;
+
+	if (dt > 0)
+	{
+		scl_freq = (long)(scl_count * 1000000000LL / dt);
+	}
+
+	qDebug() << "I2CBus::MeasureRead() delay " << shot_delay << ": " << scl_freq << " Hz, " << stretch_count << " stretched clocks";
+
+	return OK;
+}
+
 void I2CBus::Close(void)
 {
 	qDebug() << "I2CBus::Close() busI=" << (hex) << busI << (dec);
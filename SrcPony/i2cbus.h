@@ -29,6 +29,9 @@
 
 #include "busio.h"
 
+#define I2C_MAX_PAGE    512     //largest write page (24M01/24M02 class)
+#define I2C_CAL_LEN     64      //block read back by Calibration()
+
 class I2CBus : public BusIO
 {
   public:                //------------------------------- public
@@ -46,15 +49,50 @@ class I2CBus : public BusIO
 	int Stop();
 	int Reset();
 
+	//Block transfers at a 1 or 2 byte word address. A read is a single
+	// sequential transaction unless it exceeds the max burst (0 = no limit),
+	// a write must fit in a device page.
+	long ReadBlock(int slave, long addr, int addr_bytes, uint8_t *data, long length);
+	long WriteBlock(int slave, long addr, int addr_bytes, uint8_t const *data, long length);
+
+	void SetMaxBurst(long len)
+	{
+		max_burst = (len > 0) ? len : 0;
+	}
+	long GetMaxBurst() const
+	{
+		return max_burst;
+	}
+
+	//Bus scan: an address-only transaction probes a 7-bit address. Each
+	// address is probed once per bus session (until the next Reset()),
+	// when it's first asked for or by a full Scan(). A failed transfer to
+	// a listed device drops the results.
+	int Scan(bool force = false);
+	int IsPresent(int slave);       //1 if present, 0 if not, < 0 error
+	void ForgetScan()
+	{
+		memset(scan_done, 0, sizeof(scan_done));
+	}
+
 	void Close();
 	int TestPort(int port);
-	//      int Calibration(int slave = 0xA0);
+
+	//Adaptive speed: find the fastest delay the device reads back
+	// reliably at and store it for the device type in the profile
+	bool NeedCalibration();
+	int Calibration(int slave, int addr_bytes);
+	long GetSCLFrequency() const    //measured by the last Calibration()
+	{
+		return scl_freq;
+	}
 
 	void SetDelay();
 
   protected:             //------------------------------- protected
 
 	int CheckBusy();
+	int WaitSCLHigh();
 	int SendStart();
 	int SendStop();
 	int SendBitMast(int b);
@@ -66,6 +104,20 @@ class I2CBus : public BusIO
 
   private:               //------------------------------- private
 
+	int SendWordAddress(int slave, long addr, int addr_bytes);
+	int MeasureRead(int slave, int addr_bytes, uint8_t *data);
+
+	long max_burst;
+
+	int ProbeAddress(int k);
+
+	uint8_t scan_map[128 / 8];      //one bit per 7-bit address, present
+	uint8_t scan_done[128 / 8];     //one bit per 7-bit address, probed in this session
+	BusInterface *scan_busI;
+
+	long scl_count;                 //SCL pulses, to measure the frequency
+	long stretch_count;             //pulses held low by a slave
+	long scl_freq;
 
 	void setSCLSDA()
 	{
@@ -231,10 +231,14 @@ int IMBus::WaitReadyAfterWrite(int addr, int delay, long timeout)
 	}
 	else
 	{
-		uint8_t val = 0xff;
+		rval = E2P_TIMEOUT;
 
-		while ((val & (1 << 1)) && timeout--)
+		PollStart(POLL_WRITE, timeout);
+
+		while (PollWait())
 		{
+			uint8_t val;
+
 			//Read status location at address 526
 
 			//Send address code
@@ -246,11 +250,13 @@ int IMBus::WaitReadyAfterWrite(int addr, int delay, long timeout)
 			SendAddrWord(IMADDR_READ(SecondaryAddress));
 			val = (uint8_t)RecDataWord(Data16_mode ? 16 : 8);
 			IdentPulse();
-		}
 
-		if (timeout == 0)
-		{
-			rval = E2P_TIMEOUT;
+			if (!(val & (1 << 1)))
+			{
+				PollReady();
+				rval = OK;
+				break;
+			}
 		}
 	}
 
@@ -291,12 +297,9 @@ long IMBus::Read(int addr, uint8_t *data, long length, int page_size)
 		*data++ = (uint8_t)RecDataWord(Data16_mode ? 16 : 8);
 		IdentPulse();
 
-		if ((len % 4) == 0)
+		if (ReadProgress(len, length))
 		{
-			if (ReadProgress(len * 100 / length))
-			{
-				break;
-			}
+			break;
 		}
 	}
 
@@ -373,7 +376,7 @@ long IMBus::Write(int addr, uint8_t const *data, long length, int page_size)
 			return E2ERR_WRITEFAILED;
 		}
 
-		if (WriteProgress(len * 100 / length))
+		if (WriteProgress(len, length))
 		{
 			break;
 		}
@@ -53,6 +53,9 @@ static QVector<Interf2Index> index_interface =
 	{1, 4, "EasyI2C-API", EASYI2C_API},
 	{1, 5, "EasyI2C-I/O", EASYI2C_IO},
 	{1, 6, "Linux SysFs GPIO", LINUXSYSFS_IO},
+	{1, 7, "Linux GPIO Chip", LINUXGPIOCHIP_IO},
+	{1, 8, "Linux GPIO MMap", LINUXGPIOMEM_IO},
+	{1, 9, "Virtual Target", VIRTUAL_IO},
 };
 
 QStringList GetInterfList(int vector)
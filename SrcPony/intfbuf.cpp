@@ -410,6 +410,7 @@ int IntelFileBuf::Load(int loadtype, long relocation_offset)
 				break;
 			}
 
+			SetUsed(dp + laddr, bcount);
 			img_size = laddr + bcount;
 		}
 		else if (rectype == SEG_ADDR_RECORD)
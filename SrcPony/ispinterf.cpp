@@ -122,14 +122,11 @@ AvrISPInterface::AvrISPInterface(bool use_io)
 
 void AvrISPInterface::SetControlLine(int res)
 {
-	qDebug() << "AvrISPInterface::SetControlLine(" << res << ") *** Inst=" << IsInstalled();
+	qDebugEdge() << "AvrISPInterface::SetControlLine(" << res << ") *** Inst=" << IsInstalled();
 
 	if (IsInstalled())
 	{
-		if (cmdWin->GetPolarity() & RESETINV)
-		{
-			res = !res;
-		}
+		res = CtrlLevel(res);
 
 		//1) Open collector RESET behaviour
 		//OutDataMask(WF_RST|WF_ENA1, !res);    //When not resetted leave the RESET in Hi-Z
@@ -227,14 +224,11 @@ void AvrISPInterface::Close()
 
 void AvrISPInterface::SetDataOut(int sda)
 {
-	qDebug() << "AvrISPInterface::SetDataOut(" << sda << ") *** Inst=" << IsInstalled();
+	qDebugEdge() << "AvrISPInterface::SetDataOut(" << sda << ") *** Inst=" << IsInstalled();
 
 	if (IsInstalled())
 	{
-		if (cmdWin->GetPolarity()&DOUTINV)
-		{
-			sda = !sda;
-		}
+		sda = DataOutLevel(sda);
 
 		OutDataMask(WF_DOUT, sda ? 1 : 0);
 	}
@@ -242,14 +236,11 @@ void AvrISPInterface::SetDataOut(int sda)
 
 void AvrISPInterface::SetClock(int scl)
 {
-	qDebug() << "AvrISPInterface::SetClock(" << scl << ") *** Inst=" << IsInstalled();
+	qDebugEdge() << "AvrISPInterface::SetClock(" << scl << ") *** Inst=" << IsInstalled();
 
 	if (IsInstalled())
 	{
-		if (cmdWin->GetPolarity()&CLOCKINV)
-		{
-			scl = !scl;
-		}
+		scl = ClockLevel(scl);
 
 		OutDataMask(WF_SCK, scl ? 1 : 0);
 	}
@@ -257,29 +248,28 @@ void AvrISPInterface::SetClock(int scl)
 
 void AvrISPInterface::SetClockData()
 {
-	qDebug() << "AvrISPInterface::SetClockData() *** Inst=" << IsInstalled();
+	qDebugEdge() << "AvrISPInterface::SetClockData() *** Inst=" << IsInstalled();
 
 	if (IsInstalled())
 	{
-		int control     = cmdWin->GetPolarity();
 		uint8_t cpreg = GetLastData();
 
-		if (control & CLOCKINV)
+		if (ClockLevel(1))
 		{
-			cpreg &= ~WF_SCK;
+			cpreg |= WF_SCK;
 		}
 		else
 		{
-			cpreg |= WF_SCK;
+			cpreg &= ~WF_SCK;
 		}
 
-		if (control & DOUTINV)
+		if (DataOutLevel(1))
 		{
-			cpreg &= ~WF_DOUT;
+			cpreg |= WF_DOUT;
 		}
 		else
 		{
-			cpreg |= WF_DOUT;
+			cpreg &= ~WF_DOUT;
 		}
 
 		OutDataPort(cpreg);
@@ -289,14 +279,13 @@ void AvrISPInterface::SetClockData()
 
 void AvrISPInterface::ClearClockData()
 {
-	qDebug() << "AvrISPInterface::ClearClockData() *** Inst=" << IsInstalled();
+	qDebugEdge() << "AvrISPInterface::ClearClockData() *** Inst=" << IsInstalled();
 
 	if (IsInstalled())
 	{
-		int control = cmdWin->GetPolarity();
 		uint8_t cpreg = GetLastData();
 
-		if (control & CLOCKINV)
+		if (ClockLevel(0))
 		{
 			cpreg |= WF_SCK;
 		}
@@ -305,7 +294,7 @@ void AvrISPInterface::ClearClockData()
 			cpreg &= ~WF_SCK;
 		}
 
-		if (control & DOUTINV)
+		if (DataOutLevel(0))
 		{
 			cpreg |= WF_DOUT;
 		}
@@ -321,18 +310,11 @@ void AvrISPInterface::ClearClockData()
 
 int AvrISPInterface::GetDataIn()
 {
-	qDebug() << "AvrISPInterface::GetDataIn() *** Inst=" << IsInstalled();
+	qDebugEdge() << "AvrISPInterface::GetDataIn() *** Inst=" << IsInstalled();
 
 	if (IsInstalled())
 	{
-		if (cmdWin->GetPolarity() & DININV)
-		{
-			return ~ InDataPort() & RF_DIN;
-		}
-		else
-		{
-			return InDataPort() & RF_DIN;
-		}
+		return DataInLevel(InDataPort() & RF_DIN);
 	}
 
 	return E2ERR_NOTINSTALLED;
@@ -346,7 +328,7 @@ int AvrISPInterface::GetClock()
 
 int AvrISPInterface::GetPresence()
 {
-	qDebug() << "AvrISPInterface::GetPresence() *** Inst=" << IsInstalled();
+	qDebugEdge() << "AvrISPInterface::GetPresence() *** Inst=" << IsInstalled();
 
 	if (IsInstalled())
 	{
@@ -360,14 +342,14 @@ int AvrISPInterface::GetPresence()
 
 int AvrISPInterface::IsClockDataUP()
 {
-	qDebug() << "AvrISPInterface::IsClockDataUP() *** Inst=" << IsInstalled();
+	qDebugEdge() << "AvrISPInterface::IsClockDataUP() *** Inst=" << IsInstalled();
 
 	return GetDataIn();
 }
 
 int AvrISPInterface::IsClockDataDOWN()
 {
-	qDebug() << "AvrISPInterface::IsClockDataDOWN() *** Inst=" << IsInstalled();
+	qDebugEdge() << "AvrISPInterface::IsClockDataDOWN() *** Inst=" << IsInstalled();
 
 	return !GetDataIn();
 }
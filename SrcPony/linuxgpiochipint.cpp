@@ -0,0 +1,304 @@
+//=========================================================================//
+//                                                                         //
+//  PonyProg - Serial Device Programmer                                    //
+//                                                                         //
+//  Copyright (C) 1997-2017   Claudio Lanconelli                           //
+//                                                                         //
+//  http://ponyprog.sourceforge.net                                        //
+//                                                                         //
+//-------------------------------------------------------------------------//
+//                                                                         //
+// This program is free software; you can redistribute it and/or           //
+// modify it under the terms of the GNU  General Public License            //
+// as published by the Free Software Foundation; either version2 of        //
+// the License, or (at your option) any later version.                     //
+//                                                                         //
+// This program is distributed in the hope that it will be useful,         //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of          //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       //
+// General Public License for more details.                                //
+//                                                                         //
+// You should have received a copy of the GNU  General Public License      //
+// along with this program (see LICENSE);     if not, write to the         //
+// Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA. //
+//                                                                         //
+//=========================================================================//
+
+// Linux GPIO character device IO (raspberry, embedded PC, gpio-sim for testing)
+
+#include "linuxgpiochipint.h"
+#include "errcode.h"
+#include "e2cmdw.h"
+
+#include <QDebug>
+#include <QString>
+
+#ifdef  __linux__
+# include <errno.h>
+# include <string.h>
+# include <unistd.h>
+# include <fcntl.h>
+# include <sys/ioctl.h>
+# include <linux/gpio.h>
+#endif
+
+#ifdef  GPIO_V2_GET_LINE_IOCTL
+# define HAVE_GPIO_V2
+#endif
+
+#define GPIO_CONSUMER           "ponyprog"
+
+//Line index inside the line request
+#define LINE_CTRL               0
+#define LINE_CLOCK              1
+#define LINE_DATAOUT            2
+#define LINE_DATAIN             3
+#define NUM_LINES               4
+
+#define BIT_CTRL                (1 << LINE_CTRL)
+#define BIT_CLOCK               (1 << LINE_CLOCK)
+#define BIT_DATAOUT             (1 << LINE_DATAOUT)
+#define BIT_DATAIN              (1 << LINE_DATAIN)
+
+LinuxGpioChipInterface::LinuxGpioChipInterface()
+{
+	pin_ctrl = pin_clock = pin_datain = pin_dataout = -1;
+	fd_lines = -1;
+}
+
+LinuxGpioChipInterface::~LinuxGpioChipInterface()
+{
+	Close();
+}
+
+int LinuxGpioChipInterface::SetPower(bool onoff)
+{
+	qDebug() << "LinuxGpioChipInterface::SetPower(" << onoff << ")";
+	return OK;
+}
+
+int LinuxGpioChipInterface::InitPins()
+{
+	pin_ctrl = E2Profile::GetGpioPinCtrl();
+	pin_datain = E2Profile::GetGpioPinDataIn();
+	pin_dataout = E2Profile::GetGpioPinDataOut();
+	pin_clock = E2Profile::GetGpioPinClock();
+
+	QString chipname = E2Profile::GetGpioChipDev();
+
+	qDebug() << "LinuxGpioChipInterface::InitPins" << chipname << "Ctrl=" << pin_ctrl << ", Clock= " << pin_clock;
+	qDebug() << "DataIn=" << pin_datain << ", DataOut=" << pin_dataout;
+
+#ifdef  HAVE_GPIO_V2
+	int fd_chip = open(chipname.toLatin1().constData(), O_RDWR | O_CLOEXEC);
+
+	if (fd_chip < 0)
+	{
+		qWarning("Unable to open %s: %s\n", chipname.toLatin1().constData(), strerror(errno));
+		return E2ERR_OPENFAILED;
+	}
+
+	struct gpio_v2_line_request req;
+	memset(&req, 0, sizeof(req));
+
+	req.offsets[LINE_CTRL] = pin_ctrl;
+	req.offsets[LINE_CLOCK] = pin_clock;
+	req.offsets[LINE_DATAOUT] = pin_dataout;
+	req.offsets[LINE_DATAIN] = pin_datain;
+	req.num_lines = NUM_LINES;
+	strncpy(req.consumer, GPIO_CONSUMER, sizeof(req.consumer) - 1);
+
+	//All lines are outputs but datain, outputs start low
+	req.config.flags = GPIO_V2_LINE_FLAG_OUTPUT;
+	req.config.num_attrs = 2;
+	req.config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_FLAGS;
+	req.config.attrs[0].attr.flags = GPIO_V2_LINE_FLAG_INPUT;
+	req.config.attrs[0].mask = BIT_DATAIN;
+	req.config.attrs[1].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+	req.config.attrs[1].attr.values = 0;
+	req.config.attrs[1].mask = BIT_CTRL | BIT_CLOCK | BIT_DATAOUT;
+
+	int ret = ioctl(fd_chip, GPIO_V2_GET_LINE_IOCTL, &req);
+	close(fd_chip);
+
+	if (ret < 0)
+	{
+		qWarning("Unable to request GPIO lines: %s\n", strerror(errno));
+		return E2ERR_OPENFAILED;
+	}
+
+	fd_lines = req.fd;
+
+	return OK;
+#else
+	return E2ERR_NOTINSTALLED;
+#endif
+}
+
+void LinuxGpioChipInterface::DeInitPins()
+{
+#ifdef  __linux__
+
+	//closing the request releases all the lines
+	if (fd_lines >= 0)
+	{
+		close(fd_lines);
+	}
+
+#endif
+	fd_lines = -1;
+}
+
+int LinuxGpioChipInterface::Open(int com_no)
+{
+	qDebug() << "LinuxGpioChipInterface::Open(" << com_no << ") IN";
+
+	int ret_val = OK;
+
+	if (GetInstalled() != com_no)
+	{
+		if ((ret_val = InitPins()) == OK)
+		{
+			Install(com_no);
+		}
+	}
+
+	qDebug() << "LinuxGpioChipInterface::Open() = " << ret_val << " OUT";
+
+	return ret_val;
+}
+
+void LinuxGpioChipInterface::Close()
+{
+	qDebug() << "LinuxGpioChipInterface::Close() IN";
+
+	if (IsInstalled())
+	{
+		SetPower(false);
+		DeInitPins();
+		DeInstall();
+	}
+
+	qDebug() << "LinuxGpioChipInterface::Close() OUT";
+}
+
+//Set the lines selected by mask to bits, a single ioctl for any number of lines
+int LinuxGpioChipInterface::SetLines(unsigned int mask, unsigned int bits)
+{
+#ifdef  HAVE_GPIO_V2
+	struct gpio_v2_line_values lv;
+
+	lv.mask = mask;
+	lv.bits = bits;
+
+	if (ioctl(fd_lines, GPIO_V2_LINE_SET_VALUES_IOCTL, &lv) < 0)
+	{
+		qWarning("LinuxGpioChipInterface::SetLines() ioctl failed: %s\n", strerror(errno));
+		return E2ERR_WRITEFAILED;
+	}
+
+#else
+	(void)mask;
+	(void)bits;
+#endif
+	return OK;
+}
+
+// Per l'AVR e` la linea di RESET
+void LinuxGpioChipInterface::SetControlLine(int res)
+{
+	if (IsInstalled())
+	{
+		res = CtrlLevel(res);
+		BUSTRACE(TRACE_CTRL, res, TRACE_SET);
+
+		SetLines(BIT_CTRL, res ? BIT_CTRL : 0);
+	}
+}
+
+void LinuxGpioChipInterface::SetDataOut(int sda)
+{
+	if (IsInstalled())
+	{
+		sda = DataOutLevel(sda);
+		BUSTRACE(TRACE_DATAOUT, sda, TRACE_SET);
+
+		SetLines(BIT_DATAOUT, sda ? BIT_DATAOUT : 0);
+	}
+}
+
+void LinuxGpioChipInterface::SetClock(int scl)
+{
+	if (IsInstalled())
+	{
+		scl = ClockLevel(scl);
+		BUSTRACE(TRACE_CLOCK, scl, TRACE_SET);
+
+		SetLines(BIT_CLOCK, scl ? BIT_CLOCK : 0);
+	}
+}
+
+void LinuxGpioChipInterface::SetClockData()
+{
+	if (IsInstalled())
+	{
+		SetLines(BIT_CLOCK | BIT_DATAOUT, (ClockLevel(1) ? BIT_CLOCK : 0) | (DataOutLevel(1) ? BIT_DATAOUT : 0));
+		BUSTRACE(TRACE_CLOCK, ClockLevel(1), TRACE_SET);
+		BUSTRACE(TRACE_DATAOUT, DataOutLevel(1), TRACE_SET);
+	}
+}
+
+void LinuxGpioChipInterface::ClearClockData()
+{
+	if (IsInstalled())
+	{
+		SetLines(BIT_CLOCK | BIT_DATAOUT, (ClockLevel(0) ? BIT_CLOCK : 0) | (DataOutLevel(0) ? BIT_DATAOUT : 0));
+		BUSTRACE(TRACE_CLOCK, ClockLevel(0), TRACE_SET);
+		BUSTRACE(TRACE_DATAOUT, DataOutLevel(0), TRACE_SET);
+	}
+}
+
+int LinuxGpioChipInterface::GetDataIn()
+{
+	if (IsInstalled())
+	{
+		unsigned int val = 0;
+#ifdef  HAVE_GPIO_V2
+		struct gpio_v2_line_values lv;
+
+		lv.mask = BIT_DATAIN;
+		lv.bits = 0;
+
+		if (ioctl(fd_lines, GPIO_V2_LINE_GET_VALUES_IOCTL, &lv) < 0)
+		{
+			qWarning("LinuxGpioChipInterface::GetDataIn() ioctl failed: %s\n", strerror(errno));
+			return E2ERR_NOTINSTALLED;
+		}
+
+		val = (lv.bits & BIT_DATAIN) ? 1 : 0;
+#endif
+
+		BUSTRACE(TRACE_DATAIN, val, TRACE_GET);
+
+		return DataInLevel(val);
+	}
+	else
+	{
+		return E2ERR_NOTINSTALLED;
+	}
+}
+
+int LinuxGpioChipInterface::GetClock()
+{
+	return 1;
+}
+
+int LinuxGpioChipInterface::IsClockDataUP()
+{
+	return GetDataIn();
+}
+
+int LinuxGpioChipInterface::IsClockDataDOWN()
+{
+	return !GetDataIn();
+}
@@ -0,0 +1,458 @@
+//=========================================================================//
+//                                                                         //
+//  PonyProg - Serial Device Programmer                                    //
+//                                                                         //
+//  Copyright (C) 1997-2017   Claudio Lanconelli                           //
+//                                                                         //
+//  http://ponyprog.sourceforge.net                                        //
+//                                                                         //
+//-------------------------------------------------------------------------//
+//                                                                         //
+// This program is free software; you can redistribute it and/or           //
+// modify it under the terms of the GNU  General Public License            //
+// as published by the Free Software Foundation; either version2 of        //
+// the License, or (at your option) any later version.                     //
+//                                                                         //
+// This program is distributed in the hope that it will be useful,         //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of          //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       //
+// General Public License for more details.                                //
+//                                                                         //
+// You should have received a copy of the GNU  General Public License      //
+// along with this program (see LICENSE);     if not, write to the         //
+// Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA. //
+//                                                                         //
+//=========================================================================//
+
+// Linux memory mapped GPIO IO (raspberry and other SoC boards)
+
+#include "linuxgpiomemint.h"
+#include "errcode.h"
+#include "e2cmdw.h"
+
+#include <QDebug>
+#include <QString>
+#include <QVector>
+
+#ifdef  __linux__
+# include <errno.h>
+# include <string.h>
+# include <unistd.h>
+# include <fcntl.h>
+# include <sys/mman.h>
+#endif
+
+//AutoTag
+//GPIO controller register maps
+static QVector<GpioMemMap> gpiomem_map =
+{
+	//BCM2835/6/7/11 (RaspberryPi 1-4), /dev/gpiomem maps the GPIO block at 0
+	{"bcm2835", "/dev/gpiomem", 0, 4096, 0x00, 3, 10, 4, 1, 0, 0x1C, 0x28, 0x34, 32, 4},
+	//Allwinner H3/H5 (OrangePi, NanoPi) PIO block, no set/clear registers
+	{"sun8i-h3", "/dev/mem", 0x01C20000, 4096, 0x800, 4, 32, 0x24, 1, 0, -1, -1, 0x810, 32, 0x24},
+	//Anonymous memory, outputs are latched in the level register so they can be read back
+	{"sim", "", 0, 4096, 0x00, 3, 10, 4, 1, 0, -1, -1, 0x34, 32, 4}
+};
+
+const GpioMemMap *LinuxGpioMemInterface::GetMap(const QString &soc)
+{
+	for (int k = 0; k < gpiomem_map.count(); k++)
+	{
+		if (gpiomem_map.at(k).soc == soc)
+		{
+			return &gpiomem_map.at(k);
+		}
+	}
+
+	return 0;
+}
+
+LinuxGpioMemInterface::LinuxGpioMemInterface()
+{
+	map = 0;
+	regs = 0;
+	memset(&line_ctrl, 0, sizeof(line_ctrl));
+	memset(&line_clock, 0, sizeof(line_clock));
+	memset(&line_datain, 0, sizeof(line_datain));
+	memset(&line_dataout, 0, sizeof(line_dataout));
+}
+
+LinuxGpioMemInterface::~LinuxGpioMemInterface()
+{
+	Close();
+}
+
+int LinuxGpioMemInterface::SetPower(bool onoff)
+{
+	qDebug() << "LinuxGpioMemInterface::SetPower(" << onoff << ")";
+	return OK;
+}
+
+//Compute the register addresses of a pin and set its direction
+int LinuxGpioMemInterface::SetupLine(GpioLine &ln, int pin, bool out_dir)
+{
+	if (pin < 0)
+	{
+		return BADPARAM;
+	}
+
+	long fsel = map->fsel_reg + (pin / map->fsel_pins) * map->fsel_stride + ((pin % map->fsel_pins) * map->fsel_bits / 32) * 4;
+	int shift = (pin % map->fsel_pins) * map->fsel_bits % 32;
+	long dat = (pin / map->dat_pins) * map->dat_stride;
+
+	if (fsel + 4 > map->size || map->lev_reg + dat + 4 > map->size)
+	{
+		return BADPARAM;
+	}
+
+	volatile uint32_t *fsel_p = (volatile uint32_t *)(regs + fsel);
+	uint32_t fmask = ((1 << map->fsel_bits) - 1) << shift;
+
+	*fsel_p = (*fsel_p & ~fmask) | ((out_dir ? map->fsel_out : map->fsel_in) << shift);
+
+	ln.set = (map->set_reg >= 0) ? (volatile uint32_t *)(regs + map->set_reg + dat) : 0;
+	ln.clr = (map->clr_reg >= 0) ? (volatile uint32_t *)(regs + map->clr_reg + dat) : 0;
+	ln.lev = (volatile uint32_t *)(regs + map->lev_reg + dat);
+	ln.mask = 1 << (pin % map->dat_pins);
+
+	return OK;
+}
+
+int LinuxGpioMemInterface::InitPins()
+{
+	QString soc = E2Profile::GetGpioMemSoc();
+	int pin_ctrl = E2Profile::GetGpioPinCtrl();
+	int pin_datain = E2Profile::GetGpioPinDataIn();
+	int pin_dataout = E2Profile::GetGpioPinDataOut();
+	int pin_clock = E2Profile::GetGpioPinClock();
+
+	qDebug() << "LinuxGpioMemInterface::InitPins" << soc << "Ctrl=" << pin_ctrl << ", Clock= " << pin_clock;
+	qDebug() << "DataIn=" << pin_datain << ", DataOut=" << pin_dataout;
+
+	map = GetMap(soc);
+
+	if (map == 0)
+	{
+		qWarning() << "Unknown GPIO register map" << soc;
+		return E2ERR_OPENFAILED;
+	}
+
+#ifdef  __linux__
+	void *p;
+
+	if (map->device.length())
+	{
+		int fd = open(map->device.toLatin1().constData(), O_RDWR | O_SYNC | O_CLOEXEC);
+
+		if (fd < 0)
+		{
+			qWarning("Unable to open %s: %s\n", map->device.toLatin1().constData(), strerror(errno));
+			return E2ERR_ACCESSDENIED;
+		}
+
+		p = mmap(0, map->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, map->base);
+		close(fd);              //the mapping stays valid
+	}
+	else
+	{
+		p = mmap(0, map->size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	}
+
+	if (p == MAP_FAILED)
+	{
+		qWarning("Unable to map GPIO registers: %s\n", strerror(errno));
+		return E2ERR_OPENFAILED;
+	}
+
+	regs = (volatile uint8_t *)p;
+
+	if (SetupLine(line_ctrl, pin_ctrl, true) != OK ||
+			SetupLine(line_clock, pin_clock, true) != OK ||
+			SetupLine(line_dataout, pin_dataout, true) != OK ||
+			SetupLine(line_datain, pin_datain, false) != OK)
+	{
+		qWarning() << "GPIO pin out of the register map";
+		DeInitPins();
+		return E2ERR_OPENFAILED;
+	}
+
+	return OK;
+#else
+	return E2ERR_NOTINSTALLED;
+#endif
+}
+
+void LinuxGpioMemInterface::DeInitPins()
+{
+#ifdef  __linux__
+
+	if (regs)
+	{
+		munmap((void *)regs, map->size);
+	}
+
+#endif
+	regs = 0;
+}
+
+int LinuxGpioMemInterface::Open(int com_no)
+{
+	qDebug() << "LinuxGpioMemInterface::Open(" << com_no << ") IN";
+
+	int ret_val = OK;
+
+	if (GetInstalled() != com_no)
+	{
+		if ((ret_val = InitPins()) == OK)
+		{
+			Install(com_no);
+		}
+	}
+
+	qDebug() << "LinuxGpioMemInterface::Open() = " << ret_val << " OUT";
+
+	return ret_val;
+}
+
+void LinuxGpioMemInterface::Close()
+{
+	qDebug() << "LinuxGpioMemInterface::Close() IN";
+
+	if (IsInstalled())
+	{
+		SetPower(false);
+		DeInitPins();
+		DeInstall();
+	}
+
+	qDebug() << "LinuxGpioMemInterface::Close() OUT";
+}
+
+//A single store when the SoC has set/clear registers,
+// read-modify-write of the data register otherwise
+void LinuxGpioMemInterface::SetLine(const GpioLine &ln, int val)
+{
+	if (ln.set)
+	{
+		if (val)
+		{
+			*ln.set = ln.mask;
+		}
+		else
+		{
+			*ln.clr = ln.mask;
+		}
+	}
+	else
+	{
+		if (val)
+		{
+			*ln.lev |= ln.mask;
+		}
+		else
+		{
+			*ln.lev &= ~ln.mask;
+		}
+	}
+}
+
+//Two lines at once: lines of the same bank going to the same level share the store
+void LinuxGpioMemInterface::SetLines(const GpioLine &a, int va, const GpioLine &b, int vb)
+{
+	if (a.lev != b.lev)
+	{
+		SetLine(a, va);
+		SetLine(b, vb);
+	}
+	else if (a.set)
+	{
+		uint32_t smask = (va ? a.mask : 0) | (vb ? b.mask : 0);
+		uint32_t cmask = (va ? 0 : a.mask) | (vb ? 0 : b.mask);
+
+		if (smask)
+		{
+			*a.set = smask;
+		}
+
+		if (cmask)
+		{
+			*a.clr = cmask;
+		}
+	}
+	else
+	{
+		uint32_t v = *a.lev & ~(a.mask | b.mask);
+
+		if (va)
+		{
+			v |= a.mask;
+		}
+
+		if (vb)
+		{
+			v |= b.mask;
+		}
+
+		*a.lev = v;
+	}
+}
+
+// Per l'AVR e` la linea di RESET
+void LinuxGpioMemInterface::SetControlLine(int res)
+{
+	if (IsInstalled())
+	{
+		res = CtrlLevel(res);
+		BUSTRACE(TRACE_CTRL, res, TRACE_SET);
+
+		SetLine(line_ctrl, res);
+	}
+}
+
+void LinuxGpioMemInterface::SetDataOut(int sda)
+{
+	if (IsInstalled())
+	{
+		sda = DataOutLevel(sda);
+		BUSTRACE(TRACE_DATAOUT, sda, TRACE_SET);
+
+		SetLine(line_dataout, sda);
+	}
+}
+
+void LinuxGpioMemInterface::SetClock(int scl)
+{
+	if (IsInstalled())
+	{
+		scl = ClockLevel(scl);
+		BUSTRACE(TRACE_CLOCK, scl, TRACE_SET);
+
+		SetLine(line_clock, scl);
+	}
+}
+
+void LinuxGpioMemInterface::SetClockData()
+{
+	if (IsInstalled())
+	{
+		SetLines(line_clock, ClockLevel(1), line_dataout, DataOutLevel(1));
+		BUSTRACE(TRACE_CLOCK, ClockLevel(1), TRACE_SET);
+		BUSTRACE(TRACE_DATAOUT, DataOutLevel(1), TRACE_SET);
+	}
+}
+
+void LinuxGpioMemInterface::ClearClockData()
+{
+	if (IsInstalled())
+	{
+		SetLines(line_clock, ClockLevel(0), line_dataout, DataOutLevel(0));
+		BUSTRACE(TRACE_CLOCK, ClockLevel(0), TRACE_SET);
+		BUSTRACE(TRACE_DATAOUT, DataOutLevel(0), TRACE_SET);
+	}
+}
+
+int LinuxGpioMemInterface::GetDataIn()
+{
+	if (IsInstalled())
+	{
+		int val = (*line_datain.lev & line_datain.mask) ? 1 : 0;
+
+		BUSTRACE(TRACE_DATAIN, val, TRACE_GET);
+
+		return DataInLevel(val);
+	}
+	else
+	{
+		return E2ERR_NOTINSTALLED;
+	}
+}
+
+//Same as BusInterface::SendWaveform() without a virtual call per edge
+int LinuxGpioMemInterface::SendWaveform(const uint8_t *wave, int nsteps, int delay, uint8_t *samples, int high_delay)
+{
+	if (!IsInstalled())
+	{
+		return E2ERR_NOTINSTALLED;
+	}
+
+	Wait w;
+	int state = -1;
+	int nsamples = 0;
+
+	for (int k = 0; k < nsteps; k++)
+	{
+		int clk = (wave[k] & WAVE_CLOCK) ? 1 : 0;
+		int dat = (wave[k] & WAVE_DATAOUT) ? 1 : 0;
+		bool clk_chg = (state < 0 || clk != (state & WAVE_CLOCK ? 1 : 0));
+		bool dat_chg = (state < 0 || dat != (state & WAVE_DATAOUT ? 1 : 0));
+
+		if (clk && clk_chg)
+		{
+			if (dat_chg)
+			{
+				SetLine(line_dataout, DataOutLevel(dat));
+				BUSTRACE(TRACE_DATAOUT, DataOutLevel(dat), TRACE_SET);
+			}
+
+			SetLine(line_clock, ClockLevel(1));
+			BUSTRACE(TRACE_CLOCK, ClockLevel(1), TRACE_SET);
+		}
+		else
+		{
+			if (clk_chg)
+			{
+				SetLine(line_clock, ClockLevel(clk));
+				BUSTRACE(TRACE_CLOCK, ClockLevel(clk), TRACE_SET);
+			}
+
+			if (dat_chg)
+			{
+				SetLine(line_dataout, DataOutLevel(dat));
+				BUSTRACE(TRACE_DATAOUT, DataOutLevel(dat), TRACE_SET);
+			}
+		}
+
+		state = wave[k] & (WAVE_CLOCK | WAVE_DATAOUT);
+
+		if (wave[k] & WAVE_SAMPLE)
+		{
+			if (nsamples % 8 == 0)
+			{
+				samples[nsamples / 8] = 0;
+			}
+
+			int b = (*line_datain.lev & line_datain.mask) ? 1 : 0;
+
+			BUSTRACE(TRACE_DATAIN, b, TRACE_GET);
+
+			if (DataInLevel(b))
+			{
+				samples[nsamples / 8] |= 0x80 >> (nsamples % 8);
+			}
+
+			nsamples++;
+		}
+
+		if (wave[k] & WAVE_WAIT)
+		{
+			w.WaitUsec((clk && high_delay >= 0) ? high_delay : delay);
+		}
+	}
+
+	return nsamples;
+}
+
+int LinuxGpioMemInterface::GetClock()
+{
+	return 1;
+}
+
+int LinuxGpioMemInterface::IsClockDataUP()
+{
+	return GetDataIn();
+}
+
+int LinuxGpioMemInterface::IsClockDataDOWN()
+{
+	return !GetDataIn();
+}
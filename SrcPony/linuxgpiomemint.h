@@ -0,0 +1,111 @@
+//=========================================================================//
+//                                                                         //
+//  PonyProg - Serial Device Programmer                                    //
+//                                                                         //
+//  Copyright (C) 1997-2017   Claudio Lanconelli                           //
+//                                                                         //
+//  http://ponyprog.sourceforge.net                                        //
+//                                                                         //
+//-------------------------------------------------------------------------//
+//                                                                         //
+// This program is free software; you can redistribute it and/or           //
+// modify it under the terms of the GNU  General Public License            //
+// as published by the Free Software Foundation; either version2 of        //
+// the License, or (at your option) any later version.                     //
+//                                                                         //
+// This program is distributed in the hope that it will be useful,         //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of          //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       //
+// General Public License for more details.                                //
+//                                                                         //
+// You should have received a copy of the GNU  General Public License      //
+// along with this program (see LICENSE);     if not, write to the         //
+// Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA. //
+//                                                                         //
+//=========================================================================//
+
+#ifndef _LINUXGPIOMEMINTERFACE_H
+#define _LINUXGPIOMEMINTERFACE_H
+
+#include "businter.h"
+
+#include <QString>
+
+//GPIO controller register layout of a SoC.
+//Pin p lives in bank p / pins of the function select or data block,
+// a bank is stride bytes after the previous one.
+struct GpioMemMap
+{
+	QString soc;
+	QString device;         //empty for an anonymous (simulated) mapping
+	long base;              //mmap offset, page aligned
+	long size;              //mmap length
+
+	int fsel_reg;           //function select registers
+	int fsel_bits;          //bits per pin
+	int fsel_pins;          //pins per bank
+	int fsel_stride;
+	int fsel_out;           //function code of an output pin
+	int fsel_in;            //function code of an input pin
+
+	int set_reg;            //output set register (-1 if the SoC has none)
+	int clr_reg;            //output clear register (-1 if the SoC has none)
+	int lev_reg;            //pin level (data) register
+	int dat_pins;           //pins per bank
+	int dat_stride;
+};
+
+//Memory mapped GPIO interface (/dev/gpiomem, /dev/mem).
+//Pins are driven with plain stores to the controller registers.
+class LinuxGpioMemInterface : public BusInterface
+{
+  public:                //------------------------------- public
+	LinuxGpioMemInterface();
+	virtual ~LinuxGpioMemInterface();
+
+	virtual int Open(int com_no);
+	virtual void Close();
+
+	virtual void SetDataOut(int sda = 1);
+	virtual void SetClock(int scl = 1);
+	virtual int GetDataIn();
+	virtual int GetClock();
+	virtual void SetClockData();
+	virtual void ClearClockData();
+	virtual int IsClockDataUP();
+	virtual int IsClockDataDOWN();
+
+	virtual int SendWaveform(const uint8_t *wave, int nsteps, int delay, uint8_t *samples, int high_delay = -1);
+
+	int SetPower(bool onoff);
+	void SetControlLine(int res = 1);
+
+	static const GpioMemMap *GetMap(const QString &soc);
+
+  protected:             //------------------------------- protected
+
+  private:               //------------------------------- private
+	struct GpioLine
+	{
+		volatile uint32_t *set;
+		volatile uint32_t *clr;
+		volatile uint32_t *lev;
+		uint32_t mask;
+	};
+
+	int InitPins();
+	void DeInitPins();
+	int SetupLine(GpioLine &ln, int pin, bool out_dir);
+	void SetLine(const GpioLine &ln, int val);
+	void SetLines(const GpioLine &a, int va, const GpioLine &b, int vb);
+
+	const GpioMemMap *map;
+	volatile uint8_t *regs;
+
+	GpioLine line_ctrl;
+	GpioLine line_clock;
+	GpioLine line_datain;
+	GpioLine line_dataout;
+};
+
+#endif
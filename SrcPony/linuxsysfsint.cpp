@@ -274,14 +274,12 @@ void LinuxSysFsInterface::Close()
 // Per l'AVR e` la linea di RESET
 void LinuxSysFsInterface::SetControlLine(int res)
 {
-	qDebug() << "LinuxSysFsInterface::SetControlLine(" << res << ") *** Inst=" <<  IsInstalled() << ", fd=" << fd_ctrl;
+	qDebugEdge() << "LinuxSysFsInterface::SetControlLine(" << res << ") *** Inst=" <<  IsInstalled() << ", fd=" << fd_ctrl;
 
 	if (IsInstalled())
 	{
-		if (cmdWin->GetPolarity() & RESETINV)
-		{
-			res = !res;
-		}
+		res = CtrlLevel(res);
+		BUSTRACE(TRACE_CTRL, res, TRACE_SET);
 
 #ifdef  __linux__
 		int ret;
@@ -307,14 +305,12 @@ void LinuxSysFsInterface::SetControlLine(int res)
 
 void LinuxSysFsInterface::SetDataOut(int sda)
 {
-	qDebug() << "LinuxSysFsInterface::SetDataOut(" << sda << ") *** Inst=" << IsInstalled() << ", fd=" << fd_dataout;
+	qDebugEdge() << "LinuxSysFsInterface::SetDataOut(" << sda << ") *** Inst=" << IsInstalled() << ", fd=" << fd_dataout;
 
 	if (IsInstalled())
 	{
-		if ((cmdWin->GetPolarity() & DOUTINV))
-		{
-			sda = !sda;
-		}
+		sda = DataOutLevel(sda);
+		BUSTRACE(TRACE_DATAOUT, sda, TRACE_SET);
 
 #ifdef  __linux__
 		int ret;
@@ -340,14 +336,12 @@ void LinuxSysFsInterface::SetDataOut(int sda)
 
 void LinuxSysFsInterface::SetClock(int scl)
 {
-	qDebug() << "LinuxSysFsInterface::SetClock(" << scl << ") *** Inst=" << IsInstalled() << ", fd=" << fd_clock;
+	qDebugEdge() << "LinuxSysFsInterface::SetClock(" << scl << ") *** Inst=" << IsInstalled() << ", fd=" << fd_clock;
 
 	if (IsInstalled())
 	{
-		if ((cmdWin->GetPolarity() & CLOCKINV))
-		{
-			scl = !scl;
-		}
+		scl = ClockLevel(scl);
+		BUSTRACE(TRACE_CLOCK, scl, TRACE_SET);
 
 #ifdef  __linux__
 		int ret;
@@ -373,7 +367,7 @@ void LinuxSysFsInterface::SetClock(int scl)
 
 void LinuxSysFsInterface::SetClockData()
 {
-	qDebug() << "LinuxSysFsInterface::SetClockData() *** Inst=" << IsInstalled();
+	qDebugEdge() << "LinuxSysFsInterface::SetClockData() *** Inst=" << IsInstalled();
 
 	if (IsInstalled())
 	{
@@ -385,7 +379,7 @@ void LinuxSysFsInterface::SetClockData()
 
 void LinuxSysFsInterface::ClearClockData()
 {
-	qDebug() << "LinuxSysFsInterface::ClearClockData() *** Inst=" << IsInstalled();
+	qDebugEdge() << "LinuxSysFsInterface::ClearClockData() *** Inst=" << IsInstalled();
 
 	if (IsInstalled())
 	{
@@ -414,16 +408,11 @@ int LinuxSysFsInterface::GetDataIn()
 		}
 
 #endif
-		qDebug() << "LinuxSysFsInterface::GetDataIn()=" << val << ", fd=" << fd_datain;
+		qDebugEdge() << "LinuxSysFsInterface::GetDataIn()=" << val << ", fd=" << fd_datain;
 
-		if (cmdWin->GetPolarity() & DININV)
-		{
-			return !val;
-		}
-		else
-		{
-			return val;
-		}
+		BUSTRACE(TRACE_DATAIN, val, TRACE_GET);
+
+		return DataInLevel(val);
 	}
 	else
 	{
@@ -438,14 +427,14 @@ int LinuxSysFsInterface::GetClock()
 
 int LinuxSysFsInterface::IsClockDataUP()
 {
-	qDebug() << "LinuxSysFsInterface::IsClockDataUP() *** Inst=" << IsInstalled();
+	qDebugEdge() << "LinuxSysFsInterface::IsClockDataUP() *** Inst=" << IsInstalled();
 
 	return GetDataIn();
 }
 
 int LinuxSysFsInterface::IsClockDataDOWN()
 {
-	qDebug() << "LinuxSysFsInterface::IsClockDataDOWN() *** Inst=" << IsInstalled();
+	qDebugEdge() << "LinuxSysFsInterface::IsClockDataDOWN() *** Inst=" << IsInstalled();
 
 	return !GetDataIn();
 }
@@ -248,16 +248,23 @@ int MicroWireBus::WaitReadyAfterWrite(long timeout)
 
 	clearCLK();
 
-	long k;
+	int rval = E2P_TIMEOUT;
 
-	for (k = timeout; k > 0  &&  !getDO(); k--)
+	PollStart(POLL_WRITE, timeout);
+
+	while (PollWait())
 	{
-		WaitUsec(1);        //07/08/99 ** try to fix temporization (so to need only one global calibration)
+		if (getDO())
+		{
+			PollReady();
+			rval = OK;
+			break;
+		}
 	}
 
-	qDebug() << "MicroWireBus::WaitReadyAfterWrite() = " << k;
+	qDebug() << "MicroWireBus::WaitReadyAfterWrite() = " << rval << " (" << GetPollTime(POLL_WRITE) << " usec)";
 
-	return k ? OK : E2P_TIMEOUT;
+	return rval;
 }
 
 int MicroWireBus::Reset(void)
@@ -387,6 +387,8 @@ int MotorolaSFileBuf::Load(int loadtype, long relocation_offset)
 			fh.seek(0);
 			//                      rewind(fh);
 
+			ResetUsed();
+
 			riga[MAXLINE] = '\0';
 
 			while (!fh.atEnd())
@@ -581,6 +583,8 @@ int MotorolaSFileBuf::ParseRecord(char *lbufPC, uint8_t *buf_startP, uint8_t *bu
 			{
 				highestPC = bufPC - 1;        /* track highest address loaded */
 			}
+
+			SetUsed(buf_startP + addrL, bufPC - (buf_startP + addrL));
 		}
 	}
 
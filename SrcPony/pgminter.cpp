@@ -52,10 +52,8 @@ void SIProgInterface::SetControlLine(int res)
 {
 	if (IsInstalled())
 	{
-		if (cmdWin->GetPolarity() & RESETINV)
-		{
-			res = !res;
-		}
+		res = CtrlLevel(res);
+		BUSTRACE(TRACE_CTRL, res, TRACE_SET);
 
 		SetSerialBreak(res);
 	}
@@ -93,6 +91,7 @@ int SIProgInterface::Open(int com_no)
 			//SetPower(true);  //08/02/1998 -- ora diamo alimentazione prima di ogni operazione e la togliamo subito dopo
 
 			Install(com_no);
+			ResetSerialIoctlCount();
 		}
 	}
 
@@ -113,19 +112,17 @@ void SIProgInterface::Close()
 		RS232Interface::CloseSerial();
 	}
 
-	qDebug() << "SIProgInterface::Close() OUT";
+	qDebug() << "SIProgInterface::Close() OUT, modem ioctls=" << GetSerialIoctlCount();
 }
 
 void SIProgInterface::SetDataOut(int sda)
 {
-//	qDebug() << "SIProgInterface::SetDataOut(" << sda << ") *** Inst=" << IsInstalled();
+	qDebugEdge() << "SIProgInterface::SetDataOut(" << sda << ") *** Inst=" << IsInstalled();
 
 	if (IsInstalled())
 	{
-		if (cmdWin->GetPolarity() & DOUTINV)
-		{
-			sda = !sda;
-		}
+		sda = DataOutLevel(sda);
+		BUSTRACE(TRACE_DATAOUT, sda, TRACE_SET);
 
 		SetSerialDTR(sda);
 	}
@@ -133,14 +130,12 @@ void SIProgInterface::SetDataOut(int sda)
 
 void SIProgInterface::SetClock(int scl)
 {
-//	qDebug() << "SIProgInterface::SetClock(" << scl << ") *** Inst=" << IsInstalled();
+	qDebugEdge() << "SIProgInterface::SetClock(" << scl << ") *** Inst=" << IsInstalled();
 
 	if (IsInstalled())
 	{
-		if (cmdWin->GetPolarity() & CLOCKINV)
-		{
-			scl = !scl;
-		}
+		scl = ClockLevel(scl);
+		BUSTRACE(TRACE_CLOCK, scl, TRACE_SET);
 
 		SetSerialRTS(scl);
 	}
@@ -148,83 +143,44 @@ void SIProgInterface::SetClock(int scl)
 
 void SIProgInterface::SetClockData()
 {
-//	qDebug() << "SIProgInterface::SetClockData() *** Inst=" << IsInstalled();
+	qDebugEdge() << "SIProgInterface::SetClockData() *** Inst=" << IsInstalled();
 
 	if (IsInstalled())
 	{
-		int control = cmdWin->GetPolarity();
+		//Both lines change in a single modem control update
+		SetSerialRTSDTR(ClockLevel(1), DataOutLevel(1));
 
-		if ((control & CLOCKINV) && (control & DOUTINV))
-		{
-			SetSerialRTSDTR(0);
-		}
-		else if (!(control & CLOCKINV) && !(control & DOUTINV))
-		{
-			SetSerialRTSDTR(1);
-		}
-		else
-		{
-			if (control & CLOCKINV)
-			{
-				SetSerialRTS(0);
-				SetSerialDTR(1);
-			}
-			else
-			{
-				SetSerialRTS(1);
-				SetSerialDTR(0);
-			}
-		}
+		BUSTRACE(TRACE_CLOCK, ClockLevel(1), TRACE_SET);
+		BUSTRACE(TRACE_DATAOUT, DataOutLevel(1), TRACE_SET);
 	}
 }
 
 
 void SIProgInterface::ClearClockData()  //aggiunto il 06/03/98
 {
-//	qDebug() << "SIProgInterface::ClearClockData() *** Inst=%" << IsInstalled();
+	qDebugEdge() << "SIProgInterface::ClearClockData() *** Inst=%" << IsInstalled();
 
 	if (IsInstalled())
 	{
-		int control = cmdWin->GetPolarity();
+		//Both lines change in a single modem control update
+		SetSerialRTSDTR(ClockLevel(0), DataOutLevel(0));
 
-		if ((control & CLOCKINV) && (control & DOUTINV))
-		{
-			SetSerialRTSDTR(1);
-		}
-		else if (!(control & CLOCKINV) && !(control & DOUTINV))
-		{
-			SetSerialRTSDTR(0);
-		}
-		else
-		{
-			if (control & CLOCKINV)
-			{
-				SetSerialRTS(1);
-				SetSerialDTR(0);
-			}
-			else
-			{
-				SetSerialRTS(0);
-				SetSerialDTR(1);
-			}
-		}
+		BUSTRACE(TRACE_CLOCK, ClockLevel(0), TRACE_SET);
+		BUSTRACE(TRACE_DATAOUT, DataOutLevel(0), TRACE_SET);
 	}
 }
 
 int SIProgInterface::GetDataIn()
 {
-//	qDebug() << "SIProgInterface::GetDataIn() *** Inst=" << IsInstalled();
+	qDebugEdge() << "SIProgInterface::GetDataIn() *** Inst=" << IsInstalled();
 
 	if (IsInstalled())
 	{
-		if (cmdWin->GetPolarity() & DININV)
-		{
-			return !GetSerialCTS();
-		}
-		else
-		{
-			return GetSerialCTS();
-		}
+		int val = GetSerialCTS();
+
+		BUSTRACE(TRACE_DATAIN, val, TRACE_GET);
+
+		return DataInLevel(val);
 	}
 	else
 	{
@@ -239,14 +195,14 @@ int SIProgInterface::GetClock()
 
 int SIProgInterface::IsClockDataUP()
 {
-//	qDebug() << "SIProgInterface::GetSCLSDAup() *** Inst=" << IsInstalled();
+	qDebugEdge() << "SIProgInterface::GetSCLSDAup() *** Inst=" << IsInstalled();
 
 	return GetDataIn();
 }
 
 int SIProgInterface::IsClockDataDOWN()
 {
-//	qDebug() << "SIProgInterface::GetSCLSDAdown() *** Inst=" << IsInstalled();
+	qDebugEdge() << "SIProgInterface::GetSCLSDAdown() *** Inst=" << IsInstalled();
 
 	return !GetDataIn();
 }
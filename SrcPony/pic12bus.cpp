@@ -297,7 +297,7 @@ long Pic12Bus::BlankCheck(long length)
 			break;
 		}
 
-		if (ReadProgress(len * 100 / length))
+		if (ReadProgress(len, length))
 		{
 			break;
 		}
@@ -341,7 +341,7 @@ long Pic12Bus::Read(int addr, uint8_t *data, long length, int page_size)
 #endif
 		IncAddress(1);
 
-		if (ReadProgress(len * 100 / length))
+		if (ReadProgress(len, length))
 		{
 			break;
 		}
@@ -389,7 +389,7 @@ long Pic12Bus::Write(int addr, uint8_t const *data, long length, int page_size)
 			break;
 		}
 
-		if (WriteProgress(len * 100 / length))
+		if (WriteProgress(len, length))
 		{
 			break;
 		}
@@ -449,7 +449,7 @@ long PicBus::Read(int addr, uint8_t *data, long length, int page_size)
 			SendCmdCode(IncAddressCode);
 		}
 
-		if (ReadProgress(len * 100 / length))
+		if (ReadProgress(len, length))
 		{
 			break;
 		}
@@ -529,7 +529,7 @@ long PicBus::Write(int addr, uint8_t const *data, long length, int page_size)
 			SendCmdCode(IncAddressCode);
 		}
 
-		if (WriteProgress(len * 100 / length))
+		if (WriteProgress(len, length))
 		{
 			break;
 		}
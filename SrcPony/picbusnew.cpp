@@ -131,7 +131,7 @@ long PicBusNew::Write(int addr, uint8_t const *data, long length, int page_size)
 			SendCmdCode(IncAddressCode);
 		}
 
-		if (WriteProgress(len * 100 / length))
+		if (WriteProgress(len, length))
 		{
 			break;
 		}
@@ -91,18 +91,15 @@ PonyIOInterface::~PonyIOInterface()
 // altrimenti disabilita il BREAK --> Tx = -12v
 void PonyIOInterface::SetControlLine(int res)
 {
-	qDebug() << "PonyIOInterface::SetControlLine(" << res << ") *** Inst=" << IsInstalled();
+	qDebugEdge() << "PonyIOInterface::SetControlLine(" << res << ") *** Inst=" << IsInstalled();
 
 	if (IsInstalled())
 	{
-		qDebug() << "PonyIOInterface::SetControlLine() XX";
+		qDebugEdge() << "PonyIOInterface::SetControlLine() XX";
 
-		if (cmdWin->GetPolarity() & RESETINV)
-		{
-			res = !res;
-		}
+		res = CtrlLevel(res);
 
-		qDebug() << "PonyIOInterface::SetControlLine() " << (hex) << lcrOfst  << (dec);
+		qDebugEdge() << "PonyIOInterface::SetControlLine() " << (hex) << lcrOfst  << (dec);
 
 #ifdef  Q_OS_WIN32
 		if (res)
@@ -181,14 +178,11 @@ void PonyIOInterface::Close()
 
 void PonyIOInterface::SetDataOut(int sda)
 {
-	qDebug() << "PonyIOInterface::SetDataOut(" << sda << ") *** Inst=" << IsInstalled();
+	qDebugEdge() << "PonyIOInterface::SetDataOut(" << sda << ") *** Inst=" << IsInstalled();
 
 	if (IsInstalled())
 	{
-		if ((cmdWin->GetPolarity() & DOUTINV))
-		{
-			sda = !sda;
-		}
+		sda = DataOutLevel(sda);
 
 		if (sda)
 		{
@@ -203,14 +197,11 @@ void PonyIOInterface::SetDataOut(int sda)
 
 void PonyIOInterface::SetClock(int scl)
 {
-	qDebug() << "PonyIOInterface::SetClock(" << scl << ") *** Inst=" << IsInstalled();
+	qDebugEdge() << "PonyIOInterface::SetClock(" << scl << ") *** Inst=" << IsInstalled();
 
 	if (IsInstalled())
 	{
-		if ((cmdWin->GetPolarity() & CLOCKINV))
-		{
-			scl = !scl;
-		}
+		scl = ClockLevel(scl);
 
 		if (scl)
 		{
@@ -225,29 +216,28 @@ void PonyIOInterface::SetClock(int scl)
 
 void PonyIOInterface::SetClockData()
 {
-	qDebug() << "PonyIOInterface::SetClockData() *** Inst=" << IsInstalled();
+	qDebugEdge() << "PonyIOInterface::SetClockData() *** Inst=" << IsInstalled();
 
 	if (IsInstalled())
 	{
-		int control     = cmdWin->GetPolarity();
 		uint8_t cpreg = GetCPWReg();
 
-		if (control & CLOCKINV)
+		if (ClockLevel(1))
 		{
-			cpreg &= ~WF_SCL;
+			cpreg |= WF_SCL;
 		}
 		else
 		{
-			cpreg |= WF_SCL;
+			cpreg &= ~WF_SCL;
 		}
 
-		if (control & DOUTINV)
+		if (DataOutLevel(1))
 		{
-			cpreg &= ~WF_SDA;
+			cpreg |= WF_SDA;
 		}
 		else
 		{
-			cpreg |= WF_SDA;
+			cpreg &= ~WF_SDA;
 		}
 
 		OutPort(cpreg);
@@ -257,14 +247,13 @@ void PonyIOInterface::SetClockData()
 
 void PonyIOInterface::ClearClockData()
 {
-	qDebug() << "PonyIOInterface::ClearClockData() *** Inst=" << IsInstalled();
+	qDebugEdge() << "PonyIOInterface::ClearClockData() *** Inst=" << IsInstalled();
 
 	if (IsInstalled())
 	{
-		int control = cmdWin->GetPolarity();
 		uint8_t cpreg = GetCPWReg();
 
-		if (control & CLOCKINV)
+		if (ClockLevel(0))
 		{
 			cpreg |= WF_SCL;
 		}
@@ -273,7 +262,7 @@ void PonyIOInterface::ClearClockData()
 			cpreg &= ~WF_SCL;
 		}
 
-		if (control & DOUTINV)
+		if (DataOutLevel(0))
 		{
 			cpreg |= WF_SDA;
 		}
@@ -288,18 +277,11 @@ void PonyIOInterface::ClearClockData()
 
 int PonyIOInterface::GetDataIn()
 {
-	qDebug() << "PonyIOInterface::GetDataIn() *** Inst=" << IsInstalled();
+	qDebugEdge() << "PonyIOInterface::GetDataIn() *** Inst=" << IsInstalled();
 
 	if (IsInstalled())
 	{
-		if (cmdWin->GetPolarity() & DININV)
-		{
-			return ~ InPort() & RF_SDA;
-		}
-		else
-		{
-			return InPort() & RF_SDA;
-		}
+		return DataInLevel(InPort() & RF_SDA);
 	}
 	else
 	{
@@ -314,7 +296,7 @@ int PonyIOInterface::GetClock()
 
 int PonyIOInterface::GetPresence() const
 {
-	qDebug() << "PonyIOInterface::GetPresence() *** Inst=" << IsInstalled();
+	qDebugEdge() << "PonyIOInterface::GetPresence() *** Inst=" << IsInstalled();
 
 	if (IsInstalled())
 	{
@@ -328,14 +310,14 @@ int PonyIOInterface::GetPresence() const
 
 int PonyIOInterface::IsClockDataUP()
 {
-	qDebug() << "PonyIOInterface::IsClockDataUP() *** Inst=" << IsInstalled();
+	qDebugEdge() << "PonyIOInterface::IsClockDataUP() *** Inst=" << IsInstalled();
 
 	return GetDataIn();
 }
 
 int PonyIOInterface::IsClockDataDOWN()
 {
-	qDebug() << "PonyIOInterface::IsClockDataDOWN() *** Inst=" << IsInstalled();
+	qDebugEdge() << "PonyIOInterface::IsClockDataDOWN() *** Inst=" << IsInstalled();
 
 	return !GetDataIn();
 }
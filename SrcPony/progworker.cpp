@@ -0,0 +1,57 @@
+//=========================================================================//
+//                                                                         //
+//  PonyProg - Serial Device Programmer                                    //
+//                                                                         //
+//  Copyright (C) 1997-2017   Claudio Lanconelli                           //
+//                                                                         //
+//  http://ponyprog.sourceforge.net                                        //
+//                                                                         //
+//-------------------------------------------------------------------------//
+//                                                                         //
+// This program is free software; you can redistribute it and/or           //
+// modify it under the terms of the GNU  General Public License            //
+// as published by the Free Software Foundation; either version2 of        //
+// the License, or (at your option) any later version.                     //
+//                                                                         //
+// This program is distributed in the hope that it will be useful,         //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of          //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       //
+// General Public License for more details.                                //
+//                                                                         //
+// You should have received a copy of the GNU  General Public License      //
+// along with this program (see LICENSE);     if not, write to the         //
+// Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA. //
+//                                                                         //
+//=========================================================================//
+
+
+#include "progworker.h"
+#include "e2profil.h"
+#include "errcode.h"
+
+#include <QDebug>
+
+ProgWorker::ProgWorker()
+	: result(OK)
+{
+}
+
+void ProgWorker::Start(std::function<int()> op)
+{
+	operation = op;
+	result = OK;
+	status.Start();
+
+	//bit-bang timing is better with a real time thread, if allowed
+	start(E2Profile::GetProgThreadRealTime() ? QThread::TimeCriticalPriority : QThread::InheritPriority);
+}
+
+void ProgWorker::run()
+{
+	qDebug() << "ProgWorker::run() - IN";
+
+	result = operation();
+	status.End();
+
+	qDebug() << "ProgWorker::run() = " << result << " - OUT";
+}
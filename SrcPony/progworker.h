@@ -0,0 +1,124 @@
+//=========================================================================//
+//                                                                         //
+//  PonyProg - Serial Device Programmer                                    //
+//                                                                         //
+//  Copyright (C) 1997-2017   Claudio Lanconelli                           //
+//                                                                         //
+//  http://ponyprog.sourceforge.net                                        //
+//                                                                         //
+//-------------------------------------------------------------------------//
+//                                                                         //
+// This program is free software; you can redistribute it and/or           //
+// modify it under the terms of the GNU  General Public License            //
+// as published by the Free Software Foundation; either version2 of        //
+// the License, or (at your option) any later version.                     //
+//                                                                         //
+// This program is distributed in the hope that it will be useful,         //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of          //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       //
+// General Public License for more details.                                //
+//                                                                         //
+// You should have received a copy of the GNU  General Public License      //
+// along with this program (see LICENSE);     if not, write to the         //
+// Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA. //
+//                                                                         //
+//=========================================================================//
+
+
+#ifndef _PROGWORKER_H
+#define _PROGWORKER_H
+
+#include <QThread>
+#include <QAtomicInt>
+
+#include <functional>
+
+#define PROG_POLL_MSEC  50      //GUI polling period of the status block
+
+//Status block shared by the programming thread and the GUI. The GUI
+// polls it at a fixed rate, the bus code never touches the GUI.
+class ProgStatus
+{
+  public:               //---------------------------------------- public
+
+	ProgStatus()
+		: progress(0), abort(0), busy(0)
+	{
+	}
+
+	void Start()
+	{
+		progress.storeRelease(0);
+		abort.storeRelease(0);
+		busy.storeRelease(1);
+	}
+	void End()
+	{
+		busy.storeRelease(0);
+	}
+	bool IsBusy() const
+	{
+		return busy.loadAcquire() != 0;
+	}
+
+	void SetProgress(int val)
+	{
+		progress.storeRelease(val);
+	}
+	int GetProgress() const
+	{
+		return progress.loadAcquire();
+	}
+
+	//the abort request stays set until the next operation starts
+	void SetAbort()
+	{
+		abort.storeRelease(1);
+	}
+	bool IsAborted() const
+	{
+		return abort.loadAcquire() != 0;
+	}
+	void ClearAbort()
+	{
+		abort.storeRelease(0);
+	}
+
+  private:              //--------------------------------------- private
+
+	QAtomicInt progress;    //0-100
+	QAtomicInt abort;
+	QAtomicInt busy;        //an operation is running on the worker
+};
+
+//Programming engine: runs a device operation on its own thread
+class ProgWorker : public QThread
+{
+  public:               //---------------------------------------- public
+
+	ProgWorker();
+
+	ProgStatus *GetStatus()
+	{
+		return &status;
+	}
+
+	//Start op on the worker thread, wait() for it and then GetResult()
+	void Start(std::function<int()> op);
+	int GetResult() const
+	{
+		return result;
+	}
+
+  protected:    //--------------------------------------- protected
+
+	void run();
+
+  private:              //--------------------------------------- private
+
+	ProgStatus status;
+	std::function<int()> operation;
+	int result;
+};
+
+#endif
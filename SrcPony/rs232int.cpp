@@ -31,7 +31,9 @@
 
 #include "e2profil.h"
 #include "rs232int.h"
+#include "simtarget.h"
 #include "errcode.h"
+#include "wait.h"
 
 #ifdef  __linux__
 #include <sys/types.h>
@@ -43,6 +45,12 @@
 #include <sys/ioctl.h>
 
 #define INVALID_HANDLE_VALUE    -1
+
+#define MODEM_RTS       TIOCM_RTS
+#define MODEM_DTR       TIOCM_DTR
+#else
+#define MODEM_RTS       0x01
+#define MODEM_DTR       0x02
 #endif
 
 RS232Interface::RS232Interface()
@@ -64,6 +72,13 @@ RS232Interface::RS232Interface()
 
 	wait_endTX_mode = false;
 
+	modem_lines = -1;
+	ioctl_count = 0;
+
+	sim = 0;
+	sim_break = 0;
+	sim_start = 0;
+
 #ifdef  Q_OS_WIN32
 	hCom = INVALID_HANDLE_VALUE;
 #elif defined(__linux__)
@@ -98,7 +113,13 @@ int RS232Interface::OpenSerial(int no)
 #ifdef Q_OS_WIN32
 		no++;           //linux call ttyS0 --> COM1, ttyS1 --> COM2, etc..
 #endif
-		devname = E2Profile::GetCOMDevName() + QString::number(no);
+		devname = E2Profile::GetCOMDevName();
+
+		//A simulated port is a single device, no numbering
+		if (!devname.startsWith(SIM_PREFIX))
+		{
+			devname += QString::number(no);
+		}
 
 		ret_val = OpenSerial(devname);
 	}
@@ -114,6 +135,23 @@ int RS232Interface::OpenSerial(QString devname)
 
 	m_devname = devname;
 
+	if (devname.startsWith(SIM_PREFIX))
+	{
+		sim = SimTarget::Create(devname.mid(qstrlen(SIM_PREFIX)));
+
+		if (sim)
+		{
+			sim_break = 0;
+			modem_lines = 0;
+			sim_start = Wait::GetTimestamp();
+			ret_val = OK;
+		}
+
+		qDebug() << "RS232Interface::OpenSerial() simulator = " << ret_val << " O";
+
+		return ret_val;
+	}
+
 #ifdef  Q_OS_WIN32
 	hCom = CreateFile((LPCWSTR)m_devname.utf16(),
 					  GENERIC_READ | GENERIC_WRITE,
@@ -199,6 +237,8 @@ int RS232Interface::OpenSerial(QString devname)
 			fd = INVALID_HANDLE_VALUE;
 			return ret_val;
 		}
+
+		modem_lines = flags;
 	}
 #endif /*TIOCMGET */
 
@@ -244,6 +284,17 @@ void RS232Interface::CloseSerial()
 {
 	qDebug() << "RS232Interface::CloseSerial()";
 
+	if (sim)
+	{
+		qDebug() << "RS232Interface::CloseSerial() simulator " << sim->GetName()
+				 << " edges=" << sim->GetEdgeCount()
+				 << " ioctls=" << ioctl_count
+				 << " msec=" << (Wait::GetTimestamp() - sim_start) / 1000000;
+
+		delete sim;
+		sim = 0;
+	}
+
 #ifdef  Q_OS_WIN32
 
 	if (hCom != INVALID_HANDLE_VALUE)
@@ -267,12 +318,22 @@ void RS232Interface::CloseSerial()
 	}
 
 #endif
+
+	modem_lines = -1;
 }
 
 int RS232Interface::SetSerialBreak(int state)
 {
 	int result = E2ERR_OPENFAILED;
 
+	if (sim)
+	{
+		ioctl_count++;
+		sim_break = state;
+		SimUpdate();
+		return OK;
+	}
+
 #ifdef  Q_OS_WIN32
 
 	if (hCom != INVALID_HANDLE_VALUE)
@@ -293,6 +354,8 @@ int RS232Interface::SetSerialBreak(int state)
 
 #if defined(TIOCSBRK) && defined(TIOCCBRK) //check if available for compilation 
 
+	ioctl_count++;
+
 	if (state)
 	{
 		result = ioctl(fd, TIOCSBRK, 0);
@@ -815,127 +878,137 @@ int RS232Interface::SetSerialTimeouts(long init_read, long while_read)
 	return result;
 }
 
-int RS232Interface::SetSerialDTR(int dtr)
+//Change the modem lines selected by mask to value with a single driver
+// request. The line state is kept in a shadow word so no read back is
+// needed, and lines already at the requested level are not touched at all.
+int RS232Interface::SetModemLines(int mask, int value)
 {
 	int result = E2ERR_OPENFAILED;
 
-#ifdef  Q_OS_WIN32
-
-	if (hCom != INVALID_HANDLE_VALUE)
+	if (sim)
 	{
-		if (EscapeCommFunction(hCom, dtr ? SETDTR : CLRDTR))
+		int lines = (modem_lines & ~mask) | (value & mask);
+
+		if (lines != modem_lines)
 		{
-			result = OK;
+			ioctl_count++;
+			modem_lines = lines;
+			SimUpdate();
 		}
-	}
 
-#elif defined(__linux__)
-	int flags;
+		return OK;
+	}
 
-	ioctl(fd, TIOCMGET, &flags);
+#ifdef  Q_OS_WIN32
 
-	if (dtr)
-	{
-		flags |= TIOCM_DTR;
-	}
-	else
+	if (hCom != INVALID_HANDLE_VALUE)
 	{
-		flags &= ~TIOCM_DTR;
-	}
-
-	result = ioctl(fd, TIOCMSET, &flags);
-#endif
+		int lines = (modem_lines < 0) ? 0 : modem_lines;
+		int changed = (modem_lines < 0) ? mask : ((lines ^ value) & mask);
+		bool ok = true;
 
-	return result;
-}
+		lines = (lines & ~mask) | (value & mask);
 
-int RS232Interface::SetSerialRTS(int rts)
-{
-	int result = E2ERR_OPENFAILED;
+		if (changed & MODEM_RTS)
+		{
+			ioctl_count++;
+			ok = EscapeCommFunction(hCom, (lines & MODEM_RTS) ? SETRTS : CLRRTS) && ok;
+		}
 
-#ifdef  Q_OS_WIN32
+		if (changed & MODEM_DTR)
+		{
+			ioctl_count++;
+			ok = EscapeCommFunction(hCom, (lines & MODEM_DTR) ? SETDTR : CLRDTR) && ok;
+		}
 
-	if (hCom != INVALID_HANDLE_VALUE)
-	{
-		if (EscapeCommFunction(hCom, rts ? SETRTS : CLRRTS))
+		if (ok)
 		{
+			modem_lines = lines;
 			result = OK;
 		}
+		else
+		{
+			modem_lines = -1;
+		}
 	}
 
 #elif defined(__linux__)
-	int flags;
-
-	ioctl(fd, TIOCMGET, &flags);
 
-	if (rts)
-	{
-		flags |= TIOCM_RTS;
-	}
-	else
+	if (fd != INVALID_HANDLE_VALUE)
 	{
-		flags &= ~TIOCM_RTS;
-	}
-
-	result = ioctl(fd, TIOCMSET, &flags);
-#endif
+		if (modem_lines < 0)
+		{
+			ioctl_count++;
 
-	return result;
-}
+			if (ioctl(fd, TIOCMGET, &modem_lines) == -1)
+			{
+				modem_lines = -1;
+				return -1;
+			}
+		}
 
-int RS232Interface::SetSerialRTSDTR(int state)
-{
-	int result = E2ERR_OPENFAILED;
+		int flags = (modem_lines & ~mask) | (value & mask);
 
-#ifdef  Q_OS_WIN32
-
-	if (hCom != INVALID_HANDLE_VALUE)
-	{
-		if (state)
+		if (flags == modem_lines)
 		{
-			EscapeCommFunction(hCom, SETRTS);
-			EscapeCommFunction(hCom, SETDTR);
-		}
-		else
-		{
-			EscapeCommFunction(hCom, CLRRTS);
-			EscapeCommFunction(hCom, CLRDTR);
+			return OK;
 		}
 
-		result = OK;
+		ioctl_count++;
+		result = ioctl(fd, TIOCMSET, &flags);
+
+		modem_lines = (result == -1) ? -1 : flags;
 	}
 
-#elif defined(__linux__)
+#endif
 
-	int flags;
-	ioctl(fd, TIOCMGET, &flags);
+	return result;
+}
 
-	if (state)
-	{
-		flags |= (TIOCM_RTS | TIOCM_DTR);
-	}
-	else
-	{
-		flags &= ~(TIOCM_RTS | TIOCM_DTR);
-	}
+int RS232Interface::SetSerialDTR(int dtr)
+{
+	return SetModemLines(MODEM_DTR, dtr ? MODEM_DTR : 0);
+}
 
-	result = ioctl(fd, TIOCMSET, &flags);
+int RS232Interface::SetSerialRTS(int rts)
+{
+	return SetModemLines(MODEM_RTS, rts ? MODEM_RTS : 0);
+}
 
-#endif
+int RS232Interface::SetSerialRTSDTR(int state)
+{
+	return SetModemLines(MODEM_RTS | MODEM_DTR, state ? (MODEM_RTS | MODEM_DTR) : 0);
+}
 
-	return result;
+//Drive RTS and DTR to independent levels in a single edge
+int RS232Interface::SetSerialRTSDTR(int rts, int dtr)
+{
+	return SetModemLines(MODEM_RTS | MODEM_DTR, (rts ? MODEM_RTS : 0) | (dtr ? MODEM_DTR : 0));
+}
+
+void RS232Interface::SimUpdate()
+{
+	sim->SetLines(sim_break, modem_lines & MODEM_RTS, modem_lines & MODEM_DTR);
 }
 
 int RS232Interface::GetSerialDSR() const
 {
 	int result = E2ERR_OPENFAILED;
 
+	if (sim)
+	{
+		ioctl_count++;
+		return (modem_lines & MODEM_RTS) ? 1 : 0;
+	}
+
 #ifdef  Q_OS_WIN32
 
 	if (hCom != INVALID_HANDLE_VALUE)
 	{
 		DWORD status;
 
+		ioctl_count++;
+
 		if (GetCommModemStatus(hCom, &status))
 		{
 			result = (status & MS_DSR_ON);
@@ -946,6 +1019,8 @@ int RS232Interface::GetSerialDSR() const
 
 	int flags;
 
+	ioctl_count++;
+
 	if (ioctl(fd, TIOCMGET, &flags) != -1)
 	{
 		result = (flags & TIOCM_DSR);
@@ -960,12 +1035,20 @@ int RS232Interface::GetSerialCTS() const
 {
 	int result = E2ERR_OPENFAILED;
 
+	if (sim)
+	{
+		ioctl_count++;
+		return sim->GetDataIn();
+	}
+
 #ifdef  Q_OS_WIN32
 
 	if (hCom != INVALID_HANDLE_VALUE)
 	{
 		DWORD status;
 
+		ioctl_count++;
+
 		if (GetCommModemStatus(hCom, &status))
 		{
 			result = (status & MS_CTS_ON);
@@ -976,6 +1059,8 @@ int RS232Interface::GetSerialCTS() const
 
 	int flags;
 
+	ioctl_count++;
+
 	if (ioctl(fd, TIOCMGET, &flags) != -1)
 	{
 		result = (flags & TIOCM_CTS);
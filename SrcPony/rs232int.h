@@ -40,6 +40,8 @@
 
 //#define MAX_COMPORTS    64
 
+class SimTarget;
+
 class RS232Interface
 {
   public:               //------------------------------- public
@@ -65,6 +67,17 @@ class RS232Interface
 	int GetSerialDSR() const;
 	int GetSerialCTS() const;
 	int SetSerialRTSDTR(int state);
+	int SetSerialRTSDTR(int rts, int dtr);
+
+	//Number of modem control requests issued to the driver
+	unsigned long GetSerialIoctlCount() const
+	{
+		return ioctl_count;
+	}
+	void ResetSerialIoctlCount()
+	{
+		ioctl_count = 0;
+	}
 
   protected:            //------------------------------- protected
 
@@ -72,6 +85,9 @@ class RS232Interface
 
   private:              //------------------------------- private
 
+	int SetModemLines(int mask, int value);
+	void SimUpdate();
+
 	QString m_devname;
 
 	long read_total_timeout, read_interval_timeout;
@@ -81,6 +97,16 @@ class RS232Interface
 	int actual_flowcontrol;
 	bool wait_endTX_mode;
 
+	int modem_lines;                        //shadow copy of the modem control word, -1 if unknown
+	mutable unsigned long ioctl_count;
+
+	//Simulated port (SIM_PREFIX device names): a SI-Prog adapter with the
+	// target model wired to TXD (reset), RTS (clock), DTR (data out),
+	// CTS (data in) and DSR looped back to RTS
+	SimTarget *sim;
+	int sim_break;
+	long long sim_start;
+
 	//      E2Profile *profile;
 #ifdef  Q_OS_WIN32
 	HANDLE hCom;
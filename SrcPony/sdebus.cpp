@@ -200,12 +200,9 @@ long Sde2506Bus::Read(int addr, uint8_t *data, long length, int page_size)
 		WaitUsec(shot_delay + 1);
 		setCE();
 
-		if ((len % 4) == 0)
+		if (ReadProgress(len, length))
 		{
-			if (ReadProgress(len * 100 / length))
-			{
-				break;
-			}
+			break;
 		}
 	}
 
@@ -249,7 +246,7 @@ long Sde2506Bus::Write(int addr, uint8_t const *data, long length, int page_size
 
 		if ((curaddr & 1))
 		{
-			if (WriteProgress(curaddr * 100 / length))
+			if (WriteProgress(curaddr, length))
 			{
 				break;
 			}
@@ -0,0 +1,1046 @@
+//=========================================================================//
+//                                                                         //
+//  PonyProg - Serial Device Programmer                                    //
+//                                                                         //
+//  Copyright (C) 1997-2017   Claudio Lanconelli                           //
+//                                                                         //
+//  http://ponyprog.sourceforge.net                                        //
+//                                                                         //
+//-------------------------------------------------------------------------//
+//                                                                         //
+// This program is free software; you can redistribute it and/or           //
+// modify it under the terms of the GNU  General Public License            //
+// as published by the Free Software Foundation; either version2 of        //
+// the License, or (at your option) any later version.                     //
+//                                                                         //
+// This program is distributed in the hope that it will be useful,         //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of          //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       //
+// General Public License for more details.                                //
+//                                                                         //
+// You should have received a copy of the GNU  General Public License      //
+// along with this program (see LICENSE);     if not, write to the         //
+// Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA. //
+//                                                                         //
+//=========================================================================//
+
+
+#include "simtarget.h"
+
+#include <QDebug>
+
+static const SimTargetInfo sim_targets[] =
+{
+	//name          type           size   size2 page  page2 twr    signature      org abits
+	{"24c02",     SIM_I2C,         256,     0,   8,    0,  5000, {0, 0, 0},          0,  0},
+	{"24c16",     SIM_I2C,         2048,    0,  16,    0,  5000, {0, 0, 0},          0,  0},
+	{"24c64",     SIM_I2C,         8192,    0,  32,    0,  5000, {0, 0, 0},          0,  0},
+	{"24c256",    SIM_I2C,         32768,   0,  64,    0,  5000, {0, 0, 0},          0,  0},
+	{"24c512",    SIM_I2C,         65536,   0, 128,    0,  5000, {0, 0, 0},          0,  0},
+	{"at90s2313", SIM_AVR,         2048,  128,   0,    0,  4000, {0x1E, 0x91, 0x01}, 0,  0},
+	{"atmega8",   SIM_AVR,         8192,  512,  64,    0,  4500, {0x1E, 0x93, 0x07}, 0,  0},
+	{"atmega328", SIM_AVR,         32768, 1024, 128,    4,  4500, {0x1E, 0x95, 0x0F}, 0,  0},
+	{"93c46",     SIM_MICROWIRE,   128,     0,   0,    0,  5000, {0, 0, 0},         16,  6},
+	{"93c46x8",   SIM_MICROWIRE,   128,     0,   0,    0,  5000, {0, 0, 0},          8,  7},
+	{"93c56",     SIM_MICROWIRE,   256,     0,   0,    0,  5000, {0, 0, 0},         16,  8},
+	{"93c66",     SIM_MICROWIRE,   512,     0,   0,    0,  5000, {0, 0, 0},         16,  8},
+	{"93c86",     SIM_MICROWIRE,   2048,    0,   0,    0,  5000, {0, 0, 0},         16, 10},
+	{"pic16f84",  SIM_PIC16,       2048,   64,   0,    0,  8000, {0, 0, 0},          0,  0},
+	{"pic16f84a", SIM_PIC16,       2048,   64,   0,    0,  4000, {0, 0, 0},          0,  0},
+	{0, 0, 0, 0, 0, 0, 0, {0, 0, 0}, 0, 0}
+};
+
+bool SimTarget::virtual_clock = false;
+long long SimTarget::virtual_ns = 0;
+
+SimTarget *SimTarget::Create(const QString &model, int page_size, int twr)
+{
+	for (int k = 0; sim_targets[k].name; k++)
+	{
+		if (model.compare(sim_targets[k].name, Qt::CaseInsensitive) == 0)
+		{
+			SimTargetInfo inf = sim_targets[k];
+
+			if (page_size >= 0 && inf.type != SIM_MICROWIRE && inf.type != SIM_PIC16)
+			{
+				inf.page_size = page_size;
+			}
+
+			if (twr >= 0)
+			{
+				inf.twr = twr;
+			}
+
+			switch (inf.type)
+			{
+			case SIM_I2C:
+				if (inf.page_size <= 0)
+				{
+					inf.page_size = 1;
+				}
+
+				return new SimI2CEeprom(inf);
+
+			case SIM_AVR:
+				return new SimAvrIsp(inf);
+
+			case SIM_MICROWIRE:
+				return new SimMicrowire(inf);
+
+			case SIM_PIC16:
+				return new SimPic16(inf);
+			}
+		}
+	}
+
+	qDebug() << "SimTarget::Create() unknown model " << model;
+
+	return 0;
+}
+
+long long SimTarget::Now()
+{
+	return virtual_clock ? virtual_ns : Wait::GetTimestamp();
+}
+
+void SimTarget::SetVirtualClock(bool on)
+{
+	virtual_clock = on;
+	virtual_ns = 0;
+}
+
+SimTarget::SimTarget(const SimTargetInfo &inf)
+	: info(inf),
+	  mem(inf.size, 0xFF),
+	  mem2(inf.size2, 0xFF),
+	  ctrl(0), clock(0), dataout(0),
+	  edge_count(0),
+	  busy_until(0)
+{
+}
+
+SimTarget::~SimTarget()
+{
+	qDebug() << "SimTarget::~SimTarget() " << info.name << " edges=" << edge_count;
+}
+
+void SimTarget::SetLines(int c, int scl, int sda)
+{
+	c = (c != 0);
+	scl = (scl != 0);
+	sda = (sda != 0);
+
+	int changed = 0;
+
+	if (c != ctrl)
+	{
+		changed |= SIM_CTRL;
+	}
+
+	if (scl != clock)
+	{
+		changed |= SIM_CLOCK;
+	}
+
+	if (sda != dataout)
+	{
+		changed |= SIM_DATAOUT;
+	}
+
+	if (changed)
+	{
+		ctrl = c;
+		clock = scl;
+		dataout = sda;
+		edge_count++;
+
+		LinesChanged(changed);
+	}
+}
+
+void SimTarget::StartWriteCycle(int factor)
+{
+	busy_until = Now() + (long long)info.twr * 1000 * factor;
+}
+
+bool SimTarget::IsBusy() const
+{
+	return busy_until && Now() < busy_until;
+}
+
+
+SimI2CEeprom::SimI2CEeprom(const SimTargetInfo &inf)
+	: SimTarget(inf),
+	  state(ST_IDLE),
+	  bitcnt(0),
+	  shift(0),
+	  sda_out(1),
+	  sda(0),
+	  ack(false),
+	  transmitting(false),
+	  addr_left(0),
+	  address(0),
+	  page_buf(inf.page_size, -1),
+	  page_addr(0)
+{
+	addr_bytes = (inf.size > 2048) ? 2 : 1;
+}
+
+int SimI2CEeprom::GetDataIn() const
+{
+	return dataout & sda_out;
+}
+
+void SimI2CEeprom::LinesChanged(int changed)
+{
+	int old_sda = sda;
+	sda = dataout & sda_out;
+
+	//START and STOP conditions: SDA changes while SCL is high
+	if (!(changed & SIM_CLOCK))
+	{
+		if (clock && old_sda != sda)
+		{
+			if (sda)
+			{
+				if (state == ST_WRITE)
+				{
+					CommitPage();
+				}
+
+				state = ST_IDLE;
+			}
+			else
+			{
+				state = ST_DEVADDR;
+			}
+
+			bitcnt = 0;
+			shift = 0;
+			sda_out = 1;
+			sda = dataout;
+			transmitting = false;
+		}
+
+		return;
+	}
+
+	if (state == ST_IDLE)
+	{
+		return;
+	}
+
+	bool reading = transmitting;
+
+	if (clock)
+	{
+		//Rising edge
+		if (!reading && bitcnt < 8)
+		{
+			shift = (shift << 1) | sda;
+		}
+		else if (reading && bitcnt == 8)
+		{
+			ack = !sda;     //ACK from the master
+		}
+
+		bitcnt++;
+	}
+	else if (!reading)
+	{
+		//Falling edge, receiving
+		if (bitcnt == 8)
+		{
+			ByteReceived();
+			sda_out = ack ? 0 : 1;
+		}
+		else if (bitcnt == 9)
+		{
+			bitcnt = 0;
+			shift = 0;
+			sda_out = 1;
+
+			if (!ack)
+			{
+				state = ST_IDLE;
+			}
+			else if (state == ST_READ)
+			{
+				transmitting = true;
+				sda_out = (mem[address] >> 7) & 1;
+			}
+		}
+	}
+	else
+	{
+		//Falling edge, transmitting
+		if (bitcnt < 8)
+		{
+			sda_out = (mem[address] >> (7 - bitcnt)) & 1;
+		}
+		else if (bitcnt == 8)
+		{
+			sda_out = 1;    //release SDA for the master ACK
+		}
+		else
+		{
+			bitcnt = 0;
+			address = (address + 1) % info.size;
+
+			if (ack)
+			{
+				sda_out = (mem[address] >> 7) & 1;
+			}
+			else
+			{
+				state = ST_IDLE;
+				transmitting = false;
+				sda_out = 1;
+			}
+		}
+	}
+
+	sda = dataout & sda_out;
+}
+
+void SimI2CEeprom::ByteReceived()
+{
+	ack = true;
+
+	switch (state)
+	{
+	case ST_DEVADDR:
+	{
+		long block_size = (addr_bytes == 1) ? 256 : 65536;
+		int nblocks = (info.size + block_size - 1) / block_size;
+		int block = (shift >> 1) & 7;
+
+		if ((shift & 0xF0) != 0xA0 || block >= nblocks || IsBusy())
+		{
+			ack = false;
+		}
+		else if (shift & 1)
+		{
+			state = ST_READ;
+		}
+		else
+		{
+			state = ST_WORDADDR;
+			addr_left = addr_bytes;
+			address = (addr_bytes == 1) ? (long)block << 8 : (long)block << 16;
+		}
+
+		break;
+	}
+
+	case ST_WORDADDR:
+		if (addr_bytes == 2 && addr_left == 2)
+		{
+			address |= (long)shift << 8;
+		}
+		else
+		{
+			address |= shift;
+		}
+
+		if (--addr_left == 0)
+		{
+			address %= info.size;
+			page_addr = address - (address % info.page_size);
+			page_buf.fill(-1);
+			state = ST_WRITE;
+		}
+
+		break;
+
+	case ST_WRITE:
+		//The address rolls over within the page
+		page_buf[address - page_addr] = shift & 0xFF;
+		address = page_addr + (address - page_addr + 1) % info.page_size;
+		break;
+
+	default:
+		break;
+	}
+}
+
+void SimI2CEeprom::CommitPage()
+{
+	bool written = false;
+
+	for (int k = 0; k < page_buf.size(); k++)
+	{
+		if (page_buf[k] >= 0)
+		{
+			mem[page_addr + k] = page_buf[k];
+			written = true;
+		}
+	}
+
+	if (written)
+	{
+		StartWriteCycle();
+	}
+}
+
+
+SimAvrIsp::SimAvrIsp(const SimTargetInfo &inf)
+	: SimTarget(inf),
+	  prog_enabled(false),
+	  bitcnt(0),
+	  shift(0),
+	  miso(0),
+	  out_byte(0),
+	  nbyte(0),
+	  page_buf(inf.page_size, 0xFF),
+	  eep_page_buf(inf.page_size2, -1),
+	  lock(0xFF), fuse(0xE1), fuse_high(0xD9), fuse_ext(0xFF),
+	  rdybsy(inf.page_size2 > 0)    //of the simulated models only the ones with EEPROM page write list $F0
+{
+}
+
+int SimAvrIsp::GetDataIn() const
+{
+	return miso;
+}
+
+void SimAvrIsp::LinesChanged(int changed)
+{
+	if (changed & SIM_CTRL)
+	{
+		//Entering or leaving the reset state restarts the serial interface
+		prog_enabled = false;
+		bitcnt = 0;
+		shift = 0;
+		nbyte = 0;
+		out_byte = 0;
+		miso = 0;
+	}
+
+	if (!ctrl || !(changed & SIM_CLOCK))
+	{
+		return;
+	}
+
+	if (clock)
+	{
+		//MOSI is latched on the rising edge
+		shift = (shift << 1) | dataout;
+		bitcnt++;
+	}
+	else
+	{
+		//MISO changes on the falling edge
+		if (bitcnt == 8)
+		{
+			ByteReceived();
+			bitcnt = 0;
+			shift = 0;
+			miso = (out_byte >> 7) & 1;
+		}
+		else
+		{
+			miso = (out_byte >> (7 - bitcnt)) & 1;
+		}
+	}
+}
+
+void SimAvrIsp::ByteReceived()
+{
+	cmd[nbyte] = shift & 0xFF;
+
+	if (nbyte < 2)
+	{
+		out_byte = cmd[nbyte];  //echo of the previous byte
+	}
+	else if (nbyte == 2)
+	{
+		out_byte = Execute();
+	}
+	else
+	{
+		Execute();
+		out_byte = 0;
+	}
+
+	nbyte = (nbyte + 1) % 4;
+}
+
+//Called with the first three bytes to produce the answer, and again with
+// all the four bytes to perform the writes
+uint8_t SimAvrIsp::Execute()
+{
+	bool last = (nbyte == 3);
+	long waddr = ((long)cmd[1] << 8) | cmd[2];
+
+	if (cmd[0] == 0xAC && cmd[1] == 0x53)
+	{
+		prog_enabled = true;
+		return cmd[2];
+	}
+
+	if (!prog_enabled)
+	{
+		return cmd[2];
+	}
+
+	if (cmd[0] == 0xF0 && rdybsy)
+	{
+		return IsBusy() ? 1 : 0;
+	}
+
+	if (IsBusy())
+	{
+		return 0xFF;
+	}
+
+	switch (cmd[0])
+	{
+	case 0x20:
+	case 0x28:
+	{
+		long a = (waddr * 2 + (cmd[0] == 0x28)) % info.size;
+		return mem[a];
+	}
+
+	case 0x40:
+	case 0x48:
+		if (last)
+		{
+			int hi = (cmd[0] == 0x48);
+
+			if (info.page_size)
+			{
+				page_buf[(waddr * 2 + hi) % info.page_size] = cmd[3];
+			}
+			else
+			{
+				mem[(waddr * 2 + hi) % info.size] &= cmd[3];
+				StartWriteCycle();
+			}
+		}
+
+		break;
+
+	case 0x4C:
+		if (last && info.page_size)
+		{
+			long a = (waddr * 2) % info.size;
+			a -= a % info.page_size;
+
+			for (int k = 0; k < info.page_size; k++)
+			{
+				mem[a + k] &= page_buf[k];
+			}
+
+			page_buf.fill(0xFF);
+			StartWriteCycle();
+		}
+
+		break;
+
+	case 0xA0:
+		return info.size2 ? mem2[waddr % info.size2] : 0xFF;
+
+	case 0xC0:
+		if (last && info.size2)
+		{
+			mem2[waddr % info.size2] = cmd[3];
+			StartWriteCycle(2);
+		}
+
+		break;
+
+	case 0xC1:
+		if (last && info.page_size2)
+		{
+			eep_page_buf[cmd[2] % info.page_size2] = cmd[3];
+		}
+
+		break;
+
+	case 0xC2:
+		if (last && info.page_size2 && info.size2)
+		{
+			long a = waddr % info.size2;
+			a -= a % info.page_size2;
+
+			for (int k = 0; k < info.page_size2; k++)
+			{
+				if (eep_page_buf[k] >= 0)
+				{
+					mem2[a + k] = (uint8_t)eep_page_buf[k];
+				}
+			}
+
+			eep_page_buf.fill(-1);
+			StartWriteCycle(2);
+		}
+
+		break;
+
+	case 0x30:
+		return info.sig[cmd[2] % 3];
+
+	case 0x38:
+		return 0xA5;    //calibration byte
+
+	case 0x58:
+		return cmd[1] ? fuse_high : lock;
+
+	case 0x50:
+		return cmd[1] ? fuse_ext : fuse;
+
+	case 0xAC:
+		if (last)
+		{
+			switch (cmd[1])
+			{
+			case 0x80:
+				mem.fill(0xFF);
+				mem2.fill(0xFF);
+				lock = 0xFF;
+				StartWriteCycle(2);
+				break;
+
+			case 0xE0:
+				lock = cmd[3];
+				break;
+
+			case 0xA0:
+				fuse = cmd[3];
+				break;
+
+			case 0xA8:
+				fuse_high = cmd[3];
+				break;
+
+			case 0xA4:
+				fuse_ext = cmd[3];
+				break;
+			}
+		}
+
+		break;
+	}
+
+	return cmd[2];
+}
+
+
+SimMicrowire::SimMicrowire(const SimTargetInfo &inf)
+	: SimTarget(inf),
+	  state(ST_START),
+	  nbits(0),
+	  shift(0),
+	  dout(1),
+	  address(0),
+	  out_word(0),
+	  nout(0),
+	  pending(OP_NONE),
+	  data(0),
+	  ewen(false)
+{
+	words = inf.size * 8 / inf.org;
+}
+
+int SimMicrowire::GetDataIn() const
+{
+	if (!ctrl)
+	{
+		return 1;
+	}
+
+	if (state == ST_START)
+	{
+		return IsBusy() ? 0 : 1;        //ready/busy status
+	}
+
+	return dout;
+}
+
+//16 bit words are stored MSB first, as At93cBus reads them
+int SimMicrowire::GetWord(long a) const
+{
+	if (info.org == 16)
+	{
+		return (mem[2 * a] << 8) | mem[2 * a + 1];
+	}
+	else
+	{
+		return mem[a];
+	}
+}
+
+void SimMicrowire::PutWord(long a, int val)
+{
+	if (info.org == 16)
+	{
+		mem[2 * a] = (val >> 8) & 0xFF;
+		mem[2 * a + 1] = val & 0xFF;
+	}
+	else
+	{
+		mem[a] = val & 0xFF;
+	}
+}
+
+void SimMicrowire::LinesChanged(int changed)
+{
+	if (changed & SIM_CTRL)
+	{
+		if (!ctrl)
+		{
+			EndCommand();
+		}
+
+		state = ST_START;
+		nbits = 0;
+		shift = 0;
+		dout = 1;
+	}
+
+	if (ctrl && (changed & SIM_CLOCK) && clock)
+	{
+		ClockRise();
+	}
+}
+
+void SimMicrowire::ClockRise()
+{
+	switch (state)
+	{
+	case ST_START:
+		if (dataout && !IsBusy())
+		{
+			state = ST_CMD;
+		}
+
+		break;
+
+	case ST_CMD:
+		shift = (shift << 1) | dataout;
+
+		if (++nbits == 2 + info.addr_bits)
+		{
+			int op = shift >> info.addr_bits;
+			address = (shift & ((1 << info.addr_bits) - 1)) % words;
+
+			nbits = 0;
+			shift = 0;
+			state = ST_DONE;
+
+			switch (op)
+			{
+			case 2:         //READ
+				state = ST_READ;
+				out_word = GetWord(address);
+				nout = 0;
+				dout = 0;       //dummy bit
+				break;
+
+			case 1:         //WRITE
+				state = ST_DATA;
+				pending = OP_WRITE;
+				break;
+
+			case 3:         //ERASE
+				pending = OP_ERASE;
+				break;
+
+			default:
+				switch ((address >> (info.addr_bits - 2)) & 3)
+				{
+				case 3:
+					ewen = true;
+					break;
+
+				case 0:
+					ewen = false;
+					break;
+
+				case 2:
+					pending = OP_ERAL;
+					break;
+
+				case 1:
+					state = ST_DATA;
+					pending = OP_WRAL;
+					break;
+				}
+
+				break;
+			}
+		}
+
+		break;
+
+	case ST_DATA:
+		shift = (shift << 1) | dataout;
+
+		if (++nbits == info.org)
+		{
+			data = shift;
+			state = ST_DONE;
+		}
+
+		break;
+
+	case ST_READ:
+		//Sequential read: the next word follows without a new command
+		if (nout == info.org)
+		{
+			address = (address + 1) % words;
+			out_word = GetWord(address);
+			nout = 0;
+		}
+
+		dout = (out_word >> (info.org - 1 - nout)) & 1;
+		nout++;
+		break;
+
+	default:
+		break;
+	}
+}
+
+//The write cycle starts when CS goes low
+void SimMicrowire::EndCommand()
+{
+	if (state == ST_DONE && ewen)
+	{
+		long k;
+
+		switch (pending)
+		{
+		case OP_WRITE:
+			PutWord(address, data);
+			StartWriteCycle();
+			break;
+
+		case OP_ERASE:
+			PutWord(address, 0xFFFF);
+			StartWriteCycle();
+			break;
+
+		case OP_ERAL:
+		case OP_WRAL:
+			for (k = 0; k < words; k++)
+			{
+				PutWord(k, pending == OP_ERAL ? 0xFFFF : data);
+			}
+
+			StartWriteCycle(2);
+			break;
+		}
+	}
+
+	pending = OP_NONE;
+}
+
+
+SimPic16::SimPic16(const SimTargetInfo &inf)
+	: SimTarget(inf),
+	  state(ST_OFF),
+	  nbits(0),
+	  shift(0),
+	  out(1),
+	  out_word(0),
+	  pc(0),
+	  latch(0x3FFF),
+	  data_mem(false),
+	  erase_prog(false),
+	  erase_data(false)
+{
+	for (int k = 0; k < 8; k++)
+	{
+		config[k] = 0x3FFF;
+	}
+}
+
+int SimPic16::GetDataIn() const
+{
+	return !dataout && out;
+}
+
+void SimPic16::LinesChanged(int changed)
+{
+	if (changed & SIM_CTRL)
+	{
+		//Program mode entry resets the address
+		state = ctrl ? ST_CMD : ST_OFF;
+		nbits = 0;
+		shift = 0;
+		out = 1;
+		pc = 0;
+	}
+
+	if (state == ST_OFF || !(changed & SIM_CLOCK))
+	{
+		return;
+	}
+
+	int din = !dataout;
+
+	if (clock)
+	{
+		//Data is shifted out on the rising edge
+		if (state == ST_DATAOUT)
+		{
+			out = (out_word >> nbits) & 1;
+		}
+
+		return;
+	}
+
+	//Data is latched on the falling edge, LSb first
+	switch (state)
+	{
+	case ST_CMD:
+		shift |= (long)din << nbits;
+
+		if (++nbits == 6)
+		{
+			int code = shift;
+			nbits = 0;
+			shift = 0;
+			Command(code);
+		}
+
+		break;
+
+	case ST_DATAIN:
+		shift |= (long)din << nbits;
+
+		if (++nbits == 16)
+		{
+			latch = (shift >> 1) & 0x3FFF;
+			nbits = 0;
+			shift = 0;
+			state = ST_CMD;
+		}
+
+		break;
+
+	case ST_DATAOUT:
+		if (++nbits == 16)
+		{
+			nbits = 0;
+			out = 1;
+			state = ST_CMD;
+		}
+
+		break;
+	}
+}
+
+void SimPic16::Command(int code)
+{
+	switch (code)
+	{
+	case 0x00:              //Load Configuration
+		pc = 0x2000;
+		data_mem = false;
+		state = ST_DATAIN;
+		break;
+
+	case 0x02:              //Load Data for Program Memory
+	case 0x03:              //Load Data for Data Memory
+		data_mem = (code == 0x03);
+		state = ST_DATAIN;
+		break;
+
+	case 0x04:              //Read Data from Program Memory
+	case 0x05:              //Read Data from Data Memory
+		data_mem = (code == 0x05);
+		out_word = (long)ReadWord() << 1;
+		state = ST_DATAOUT;
+		break;
+
+	case 0x06:              //Increment Address
+		pc = (pc + 1) & 0x3FFF;
+		break;
+
+	case 0x08:              //Begin Erase Programming Cycle
+	case 0x18:              //Begin Programming Only Cycle
+		Program(code == 0x08);
+		break;
+
+	case 0x09:              //Bulk Erase Program Memory
+		erase_prog = true;
+		break;
+
+	case 0x0B:              //Bulk Erase Data Memory
+		erase_data = true;
+		break;
+
+	default:
+		break;
+	}
+}
+
+int SimPic16::ReadWord() const
+{
+	if (IsBusy())
+	{
+		return data_mem ? 0xFF : 0x3FFF;
+	}
+
+	if (data_mem)
+	{
+		return info.size2 ? mem2[pc % info.size2] : 0xFF;
+	}
+
+	if (pc >= 0x2000)
+	{
+		return config[pc & 7];
+	}
+
+	long a = pc % (info.size / 2);
+
+	return (mem[2 * a] | (mem[2 * a + 1] << 8)) & 0x3FFF;
+}
+
+void SimPic16::Program(bool erase)
+{
+	if (IsBusy())
+	{
+		return;         //lost, the previous cycle is still running
+	}
+
+	if (erase_prog || erase_data)
+	{
+		if (erase_prog)
+		{
+			mem.fill(0xFF);
+		}
+
+		if (erase_data)
+		{
+			mem2.fill(0xFF);
+		}
+
+		erase_prog = erase_data = false;
+	}
+	else if (data_mem)
+	{
+		if (info.size2)
+		{
+			mem2[pc % info.size2] = latch & 0xFF;
+		}
+	}
+	else if (pc >= 0x2000)
+	{
+		config[pc & 7] = erase ? latch : (config[pc & 7] & latch);
+	}
+	else
+	{
+		long a = pc % (info.size / 2);
+		int val = erase ? latch : (latch & (mem[2 * a] | (mem[2 * a + 1] << 8)));
+
+		mem[2 * a] = val & 0xFF;
+		mem[2 * a + 1] = (val >> 8) & 0x3F;
+	}
+
+	StartWriteCycle();
+}
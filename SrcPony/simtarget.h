@@ -0,0 +1,327 @@
+//=========================================================================//
+//                                                                         //
+//  PonyProg - Serial Device Programmer                                    //
+//                                                                         //
+//  Copyright (C) 1997-2017   Claudio Lanconelli                           //
+//                                                                         //
+//  http://ponyprog.sourceforge.net                                        //
+//                                                                         //
+//-------------------------------------------------------------------------//
+//                                                                         //
+// This program is free software; you can redistribute it and/or           //
+// modify it under the terms of the GNU  General Public License            //
+// as published by the Free Software Foundation; either version2 of        //
+// the License, or (at your option) any later version.                     //
+//                                                                         //
+// This program is distributed in the hope that it will be useful,         //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of          //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       //
+// General Public License for more details.                                //
+//                                                                         //
+// You should have received a copy of the GNU  General Public License      //
+// along with this program (see LICENSE);     if not, write to the         //
+// Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA. //
+//                                                                         //
+//=========================================================================//
+
+
+#ifndef _SIMTARGET_H
+#define _SIMTARGET_H
+
+#include "types.h"
+#include "wait.h"
+
+#include <QString>
+#include <QVector>
+
+//Serial device names starting with this prefix open a simulated port
+#define SIM_PREFIX      "sim:"
+
+enum SimTargetType
+{
+	SIM_I2C = 1,            //24Cxx I2C bus EEPROM
+	SIM_AVR,                //AVR with serial (ISP) programming
+	SIM_MICROWIRE,          //93Cxx Microwire EEPROM
+	SIM_PIC16               //PIC16 with ICSP (serial) programming
+};
+
+//Changed line mask passed to SimTarget::LinesChanged()
+#define SIM_CTRL        0x01
+#define SIM_CLOCK       0x02
+#define SIM_DATAOUT     0x04
+
+struct SimTargetInfo
+{
+	const char *name;
+	int type;
+	long size;              //main memory (bytes)
+	long size2;             //data EEPROM (bytes), AVR only
+	int page_size;          //write page (bytes), 0 for byte writes
+	int page_size2;         //data EEPROM write page (bytes), AVR only
+	int twr;                //write cycle time (usec)
+	uint8_t sig[3];         //signature bytes, AVR only
+	int org;                //word size (8 or 16 bits), Microwire only
+	int addr_bits;          //address length (bits), Microwire only
+};
+
+//Pin level model of a target device behind a programmer.
+//It is driven with the electrical levels of the ctrl (reset), clock and
+// data out lines and answers with the level of the data in line.
+class SimTarget
+{
+  public:               //------------------------------- public
+	SimTarget(const SimTargetInfo &inf);
+	virtual ~SimTarget();
+
+	//Create the model by name, 0 if unknown.
+	//A page_size or twr >= 0 replaces the value of the model.
+	static SimTarget *Create(const QString &model, int page_size = -1, int twr = -1);
+
+	//Time of the models in nanoseconds, the system clock unless the
+	// virtual clock is enabled (see SimWaitEngine)
+	static long long Now();
+	static void SetVirtualClock(bool on);
+	static void AdvanceClock(long long nsec)
+	{
+		virtual_ns += nsec;
+	}
+
+	void SetLines(int ctrl, int clock, int dataout);
+
+	virtual int GetDataIn() const = 0;
+
+	QString GetName() const
+	{
+		return info.name;
+	}
+
+	//Memory of the target, bank 0 is the main array, 1 the data EEPROM
+	QVector<uint8_t> &GetMemory(int bank = 0)
+	{
+		return bank ? mem2 : mem;
+	}
+
+	long GetEdgeCount() const
+	{
+		return edge_count;
+	}
+
+  protected:            //------------------------------- protected
+
+	virtual void LinesChanged(int changed) = 0;
+
+	void StartWriteCycle(int factor = 1);
+	bool IsBusy() const;
+
+	const SimTargetInfo info;
+
+	QVector<uint8_t> mem;
+	QVector<uint8_t> mem2;
+
+	int ctrl, clock, dataout;
+
+  private:              //------------------------------- private
+
+	long edge_count;
+	long long busy_until;
+
+	static bool virtual_clock;
+	static long long virtual_ns;
+};
+
+//Wait engine for simulated targets: delays advance the virtual clock
+// of the models and return at once, so runs are fast and repeatable
+class SimWaitEngine : public WaitEngine
+{
+  public:               //------------------------------- public
+
+	virtual const char *GetName() const
+	{
+		return "virtual";
+	}
+
+	virtual int Calibrate()
+	{
+		return 1;
+	}
+
+	virtual void Delay(long usec)
+	{
+		SimTarget::AdvanceClock((long long)usec * 1000);
+	}
+
+	virtual bool IsVirtual() const
+	{
+		return true;
+	}
+};
+
+//24Cxx I2C bus EEPROM, SDA is open drain
+class SimI2CEeprom : public SimTarget
+{
+  public:               //------------------------------- public
+	SimI2CEeprom(const SimTargetInfo &inf);
+
+	virtual int GetDataIn() const;
+
+  protected:            //------------------------------- protected
+
+	virtual void LinesChanged(int changed);
+
+  private:              //------------------------------- private
+
+	enum
+	{
+		ST_IDLE,
+		ST_DEVADDR,
+		ST_WORDADDR,
+		ST_WRITE,
+		ST_READ
+	};
+
+	void ByteReceived();
+	void CommitPage();
+
+	int state;
+	int bitcnt;
+	int shift;
+	int sda_out;            //level driven by the slave
+	int sda;                //bus level
+	bool ack;
+	bool transmitting;
+
+	int addr_bytes;         //word address bytes (1 or 2)
+	int addr_left;
+	long address;
+
+	QVector<int> page_buf;  //pending page write, -1 where not loaded
+	long page_addr;
+};
+
+//AVR in serial programming mode, SPI mode 0 while the ctrl (reset) line is active
+class SimAvrIsp : public SimTarget
+{
+  public:               //------------------------------- public
+	SimAvrIsp(const SimTargetInfo &inf);
+
+	virtual int GetDataIn() const;
+
+  protected:            //------------------------------- protected
+
+	virtual void LinesChanged(int changed);
+
+  private:              //------------------------------- private
+
+	void ByteReceived();
+	uint8_t Execute();
+
+	bool prog_enabled;
+	int bitcnt;
+	int shift;
+	int miso;
+	uint8_t out_byte;
+
+	uint8_t cmd[4];
+	int nbyte;
+
+	QVector<uint8_t> page_buf;
+	QVector<int> eep_page_buf;      //loaded EEPROM page bytes, -1 if not loaded
+	uint8_t lock, fuse, fuse_high, fuse_ext;
+	bool rdybsy;                    //model answers Poll RDY/BSY ($F0)
+};
+
+//93Cxx Microwire EEPROM, CS is the ctrl line. After a write, DO shows
+// the ready state while CS is high.
+class SimMicrowire : public SimTarget
+{
+  public:               //------------------------------- public
+	SimMicrowire(const SimTargetInfo &inf);
+
+	virtual int GetDataIn() const;
+
+  protected:            //------------------------------- protected
+
+	virtual void LinesChanged(int changed);
+
+  private:              //------------------------------- private
+
+	enum
+	{
+		ST_START,
+		ST_CMD,
+		ST_DATA,
+		ST_READ,
+		ST_DONE
+	};
+
+	enum
+	{
+		OP_NONE,
+		OP_WRITE,
+		OP_ERASE,
+		OP_ERAL,
+		OP_WRAL
+	};
+
+	int GetWord(long a) const;
+	void PutWord(long a, int val);
+	void ClockRise();
+	void EndCommand();
+
+	int state;
+	int nbits;
+	long shift;
+	int dout;
+
+	long words;
+	long address;
+	int out_word;
+	int nout;
+
+	int pending;
+	int data;
+	bool ewen;
+};
+
+//PIC16 in ICSP mode, MCLR is the ctrl line. The data line is inverted by
+// the adapter, as in the SI-Prog PIC wiring driven by PicBus.
+class SimPic16 : public SimTarget
+{
+  public:               //------------------------------- public
+	SimPic16(const SimTargetInfo &inf);
+
+	virtual int GetDataIn() const;
+
+  protected:            //------------------------------- protected
+
+	virtual void LinesChanged(int changed);
+
+  private:              //------------------------------- private
+
+	enum
+	{
+		ST_OFF,
+		ST_CMD,
+		ST_DATAIN,
+		ST_DATAOUT
+	};
+
+	void Command(int code);
+	int ReadWord() const;
+	void Program(bool erase);
+
+	int state;
+	int nbits;
+	long shift;
+	int out;
+	long out_word;
+
+	int pc;
+	int latch;
+	bool data_mem;
+	bool erase_prog;
+	bool erase_data;
+	uint16_t config[8];
+};
+
+#endif
@@ -29,6 +29,7 @@
 
 #include "spi-bus.h"
 #include "errcode.h"
+#include "eeptypes.h"
 
 
 #include "e2cmdw.h"
@@ -51,7 +52,8 @@
 // Costruttore
 SPIBus::SPIBus(BusInterface *ptr, bool cpha)
 	: BusIO(ptr),
-	  fall_edge_sample(cpha)
+	  fall_edge_sample(cpha),
+	  sck_high_delay(-1)
 {
 }
 
@@ -93,9 +95,23 @@ void SPIBus::SetDelay()
 		break;
 	}
 
+	sck_high_delay = -1;
+
+	//minimum timing of the device datasheet, if enabled for the programmer
+	if (E2Profile::GetSPIMinTiming(E2Profile::GetParInterfType()))
+	{
+		int high_ns, low_ns;
+
+		if (GetEEPTypeSPITiming(GetPollType(), high_ns, low_ns))
+		{
+			n = (low_ns + 999) / 1000;
+			sck_high_delay = (high_ns + 999) / 1000;
+		}
+	}
+
 	BusIO::SetDelay(n);
 
-	qDebug() << "SPIBus::SetDelay() = " << n;
+	qDebug() << "SPIBus::SetDelay() = " << n << ", high = " << GetHighDelay();
 }
 
 
@@ -105,7 +121,7 @@ int SPIBus::SendDataBit(int b)
 	{
 		setSCK();               //be sure the SCK line is high
 		bitMOSI(b);
-		WaitUsec(shot_delay);
+		WaitUsec(GetHighDelay());
 		clearSCK();             //slave latches data bit now!
 		WaitUsec(shot_delay);
 	}
@@ -115,7 +131,7 @@ int SPIBus::SendDataBit(int b)
 		bitMOSI(b);
 		WaitUsec(shot_delay);
 		setSCK();               //slave latches data bit now!
-		WaitUsec(shot_delay);
+		WaitUsec(GetHighDelay());
 		clearSCK();
 	}
 
@@ -130,7 +146,7 @@ int SPIBus::RecDataBit()
 	if (fall_edge_sample)
 	{
 		setSCK();               //be sure the SCK line is high
-		WaitUsec(shot_delay);
+		WaitUsec(GetHighDelay());
 		clearSCK();
 		b = getMISO();
 		WaitUsec(shot_delay);
@@ -141,47 +157,124 @@ int SPIBus::RecDataBit()
 		WaitUsec(shot_delay);
 		setSCK();
 		b = getMISO();
-		WaitUsec(shot_delay);
+		WaitUsec(GetHighDelay());
 		clearSCK();
 	}
 
 	return b;
 }
 
-// OK, ora ci alziamo di un livello: operiamo sul byte
-int SPIBus::SendDataByte(int by)
+//Waveform of a single bit, same edges of SendDataBit() and RecDataBit()
+int SPIBus::BitWave(uint8_t *wave, int b, bool sample)
 {
-	int k;
+	uint8_t d = b ? WAVE_DATAOUT : 0;
+	uint8_t s = sample ? WAVE_SAMPLE : 0;
 
-	clearSCK();
+	if (fall_edge_sample)
+	{
+		wave[0] = WAVE_CLOCK | d | WAVE_WAIT;
+		wave[1] = d | s | WAVE_WAIT;   //slave latches data bit now!
+		return 2;
+	}
+	else
+	{
+		wave[0] = d | WAVE_WAIT;
+		wave[1] = WAVE_CLOCK | d | s | WAVE_WAIT;    //slave latches data bit now!
+		wave[2] = d;
+		return 3;
+	}
+}
+
+//Waveform of a byte sent MSbit first, MOSI is left high at the end
+int SPIBus::SendByteWave(uint8_t *wave, int by)
+{
+	int k, n = 0;
+
+	wave[n++] = (by & 0x80) ? WAVE_DATAOUT : 0;     //SCK low
 
 	//MSbit (7) sent first
 	for (k = 7; k >= 0; k--)
 	{
-		SendDataBit(by & (1 << k));
+		n += BitWave(wave + n, by & (1 << k), false);
 	}
 
-	setMOSI();
+	wave[n++] = WAVE_DATAOUT;       //MOSI high
 
-	return OK;
+	return n;
 }
 
-int SPIBus::RecDataByte()
+//Waveform of a byte received MSbit first with MOSI high
+int SPIBus::RecByteWave(uint8_t *wave)
 {
-	int k, val = 0;
+	int k, n = 0;
 
-	setMOSI();
-	clearSCK();
+	wave[n++] = WAVE_DATAOUT;       //MOSI high, SCK low
 
+	//MSbit (7) received first
 	for (k = 7; k >= 0; k--)
-		if (RecDataBit())
+	{
+		n += BitWave(wave + n, 1, true);
+	}
+
+	return n;
+}
+
+// OK, ora ci alziamo di un livello: operiamo sul byte
+int SPIBus::SendDataByte(int by)
+{
+	uint8_t wave[SPI_SENDBYTE_STEPS];
+	int n = SendByteWave(wave, by);
+
+	int rval = busI->SendWaveform(wave, n, shot_delay, 0, GetHighDelay());
+
+	return (rval < 0) ? rval : OK;
+}
+
+int SPIBus::RecDataByte()
+{
+	uint8_t wave[SPI_RECBYTE_STEPS];
+	uint8_t val;
+	int n = RecByteWave(wave);
+
+	int rval = busI->SendWaveform(wave, n, shot_delay, &val, GetHighDelay());
+
+	return (rval < 0) ? rval : val;
+}
+
+//Stream count read instructions back to back: cmd holds the 3 bytes
+// of each instruction, the byte received after them goes to data[].
+//Instructions are packed in a few waveforms to save the per byte
+// overhead. Return count or a negative error.
+long SPIBus::ReadBurst(uint8_t const *cmd, long count, uint8_t *data)
+{
+	uint8_t wave[SPI_BURST_LEN * (3 * SPI_SENDBYTE_STEPS + SPI_RECBYTE_STEPS)];
+	long k = 0;
+
+	while (k < count)
+	{
+		int j, n = 0;
+		int len = (count - k > SPI_BURST_LEN) ? SPI_BURST_LEN : (int)(count - k);
+
+		for (j = 0; j < len; j++, cmd += 3)
 		{
-			val |= 1 << k;
+			n += SendByteWave(wave + n, cmd[0]);
+			n += SendByteWave(wave + n, cmd[1]);
+			n += SendByteWave(wave + n, cmd[2]);
+			n += RecByteWave(wave + n);
 		}
 
-	return val;
-}
+		int rval = busI->SendWaveform(wave, n, shot_delay, data + k, GetHighDelay());
 
+		if (rval < 0)
+		{
+			return rval;
+		}
+
+		k += len;
+	}
+
+	return count;
+}
 
 int SPIBus::Reset(void)
 {
@@ -30,6 +30,10 @@
 #include "busio.h"
 #include "pgminter.h"
 
+#define SPI_SENDBYTE_STEPS      (2 + 8 * 3)     //max waveform steps of a sent byte
+#define SPI_RECBYTE_STEPS       (1 + 8 * 3)     //max waveform steps of a received byte
+#define SPI_BURST_LEN           16              //instructions in a single ReadBurst() waveform
+
 class SPIBus : public BusIO
 {
   public:                //------------------------------- public
@@ -48,6 +52,7 @@ class SPIBus : public BusIO
 
 	int SendDataByte(int by);
 	int RecDataByte();
+	long ReadBurst(uint8_t const *cmd, long count, uint8_t *data);
 
 	void SetReset()
 	{
@@ -71,7 +76,17 @@ class SPIBus : public BusIO
 	int SendDataBit(int b);
 	int RecDataBit();
 
+	//SCK high time, the low time is shot_delay
+	int GetHighDelay() const
+	{
+		return (sck_high_delay >= 0) ? sck_high_delay : shot_delay;
+	}
+
   private:
+	int BitWave(uint8_t *wave, int b, bool sample);
+	int SendByteWave(uint8_t *wave, int by);
+	int RecByteWave(uint8_t *wave);
+
 	void bitMOSI(int b)
 	{
 		busI->SetDataOut(b);
@@ -93,6 +108,7 @@ class SPIBus : public BusIO
 	}
 
 	bool fall_edge_sample;
+	int sck_high_delay;             //-1 to use shot_delay
 };
 
 #endif
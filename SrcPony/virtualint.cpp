@@ -0,0 +1,208 @@
+//=========================================================================//
+//                                                                         //
+//  PonyProg - Serial Device Programmer                                    //
+//                                                                         //
+//  Copyright (C) 1997-2017   Claudio Lanconelli                           //
+//                                                                         //
+//  http://ponyprog.sourceforge.net                                        //
+//                                                                         //
+//-------------------------------------------------------------------------//
+//                                                                         //
+// This program is free software; you can redistribute it and/or           //
+// modify it under the terms of the GNU  General Public License            //
+// as published by the Free Software Foundation; either version2 of        //
+// the License, or (at your option) any later version.                     //
+//                                                                         //
+// This program is distributed in the hope that it will be useful,         //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of          //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       //
+// General Public License for more details.                                //
+//                                                                         //
+// You should have received a copy of the GNU  General Public License      //
+// along with this program (see LICENSE);     if not, write to the         //
+// Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA. //
+//                                                                         //
+//=========================================================================//
+
+
+#include "virtualint.h"
+#include "errcode.h"
+#include "e2profil.h"
+
+#include <QDebug>
+
+VirtualBusInterface::VirtualBusInterface()
+{
+	target = 0;
+	ctrl = clock = dataout = 0;
+	old_engine = 0;
+	start_ns = 0;
+}
+
+VirtualBusInterface::~VirtualBusInterface()
+{
+	Close();
+}
+
+int VirtualBusInterface::SetPower(bool onoff)
+{
+	qDebug() << "VirtualBusInterface::SetPower(" << onoff << ")";
+
+	return OK;
+}
+
+int VirtualBusInterface::Open(int com_no)
+{
+	qDebug() << "VirtualBusInterface::Open(" << com_no << ") IN";
+
+	int ret_val = OK;
+
+	if (GetInstalled() != com_no)
+	{
+		QString model = E2Profile::GetVirtualTarget();
+
+		target = SimTarget::Create(model, E2Profile::GetVirtualPageSize(), E2Profile::GetVirtualWriteTime());
+
+		if (target == 0)
+		{
+			ret_val = E2ERR_OPENFAILED;
+		}
+		else
+		{
+			ctrl = clock = dataout = 0;
+
+			if (E2Profile::GetVirtualClock())
+			{
+				SimTarget::SetVirtualClock(true);
+				old_engine = Wait::GetEngine();
+				Wait::SetEngine(&sim_engine);
+			}
+
+			start_ns = SimTarget::Now();
+
+			Install(com_no);
+		}
+	}
+
+	qDebug() << "VirtualBusInterface::Open() = " << ret_val << " OUT";
+
+	return ret_val;
+}
+
+void VirtualBusInterface::Close()
+{
+	qDebug() << "VirtualBusInterface::Close() IN";
+
+	if (IsInstalled())
+	{
+		qDebug() << "VirtualBusInterface::Close() " << target->GetName()
+				 << " edges=" << target->GetEdgeCount()
+				 << " usec=" << (SimTarget::Now() - start_ns) / 1000;
+
+		SetPower(false);
+
+		if (old_engine)
+		{
+			Wait::RestoreEngine(old_engine);
+			old_engine = 0;
+		}
+
+		SimTarget::SetVirtualClock(false);
+
+		delete target;
+		target = 0;
+
+		DeInstall();
+	}
+
+	qDebug() << "VirtualBusInterface::Close() OUT";
+}
+
+void VirtualBusInterface::SetControlLine(int res)
+{
+	if (IsInstalled())
+	{
+		ctrl = CtrlLevel(res);
+		BUSTRACE(TRACE_CTRL, ctrl, TRACE_SET);
+
+		Update();
+	}
+}
+
+void VirtualBusInterface::SetDataOut(int sda)
+{
+	if (IsInstalled())
+	{
+		dataout = DataOutLevel(sda);
+		BUSTRACE(TRACE_DATAOUT, dataout, TRACE_SET);
+
+		Update();
+	}
+}
+
+void VirtualBusInterface::SetClock(int scl)
+{
+	if (IsInstalled())
+	{
+		clock = ClockLevel(scl);
+		BUSTRACE(TRACE_CLOCK, clock, TRACE_SET);
+
+		Update();
+	}
+}
+
+void VirtualBusInterface::SetClockData()
+{
+	if (IsInstalled())
+	{
+		clock = ClockLevel(1);
+		dataout = DataOutLevel(1);
+		BUSTRACE(TRACE_CLOCK, clock, TRACE_SET);
+		BUSTRACE(TRACE_DATAOUT, dataout, TRACE_SET);
+
+		Update();
+	}
+}
+
+void VirtualBusInterface::ClearClockData()
+{
+	if (IsInstalled())
+	{
+		clock = ClockLevel(0);
+		dataout = DataOutLevel(0);
+		BUSTRACE(TRACE_CLOCK, clock, TRACE_SET);
+		BUSTRACE(TRACE_DATAOUT, dataout, TRACE_SET);
+
+		Update();
+	}
+}
+
+int VirtualBusInterface::GetDataIn()
+{
+	if (IsInstalled())
+	{
+		int val = target->GetDataIn() ? 1 : 0;
+		BUSTRACE(TRACE_DATAIN, val, TRACE_GET);
+
+		return DataInLevel(val);
+	}
+	else
+	{
+		return E2ERR_NOTINSTALLED;
+	}
+}
+
+int VirtualBusInterface::GetClock()
+{
+	return 1;
+}
+
+int VirtualBusInterface::IsClockDataUP()
+{
+	return GetDataIn();
+}
+
+int VirtualBusInterface::IsClockDataDOWN()
+{
+	return !GetDataIn();
+}
@@ -0,0 +1,79 @@
+//=========================================================================//
+//                                                                         //
+//  PonyProg - Serial Device Programmer                                    //
+//                                                                         //
+//  Copyright (C) 1997-2017   Claudio Lanconelli                           //
+//                                                                         //
+//  http://ponyprog.sourceforge.net                                        //
+//                                                                         //
+//-------------------------------------------------------------------------//
+//                                                                         //
+// This program is free software; you can redistribute it and/or           //
+// modify it under the terms of the GNU  General Public License            //
+// as published by the Free Software Foundation; either version2 of        //
+// the License, or (at your option) any later version.                     //
+//                                                                         //
+// This program is distributed in the hope that it will be useful,         //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of          //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       //
+// General Public License for more details.                                //
+//                                                                         //
+// You should have received a copy of the GNU  General Public License      //
+// along with this program (see LICENSE);     if not, write to the         //
+// Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA. //
+//                                                                         //
+//=========================================================================//
+
+
+#ifndef _VIRTUALBUSINTERFACE_H
+#define _VIRTUALBUSINTERFACE_H
+
+#include "businter.h"
+#include "simtarget.h"
+
+//Interface with no hardware: the lines drive a simulated target
+// (24Cxx, AVR, 93Cxx or PIC16) selected by the VirtualTarget setting.
+//Every bus class runs unchanged on it, so it can be used to measure
+// the bus protocol cost and to check Read/Write/Verify end to end.
+class VirtualBusInterface : public BusInterface
+{
+  public:                //------------------------------- public
+	VirtualBusInterface();
+	virtual ~VirtualBusInterface();
+
+	virtual int Open(int com_no);
+	virtual void Close();
+
+	virtual void SetControlLine(int res = 1);
+	virtual void SetDataOut(int sda = 1);
+	virtual void SetClock(int scl = 1);
+	virtual int GetDataIn();
+	virtual int GetClock();
+	virtual void SetClockData();
+	virtual void ClearClockData();
+	virtual int IsClockDataUP();
+	virtual int IsClockDataDOWN();
+
+	int SetPower(bool onoff);
+
+	SimTarget *GetTarget() const
+	{
+		return target;
+	}
+
+  private:              //------------------------------- private
+
+	void Update()
+	{
+		target->SetLines(ctrl, clock, dataout);
+	}
+
+	SimTarget *target;
+	int ctrl, clock, dataout;
+
+	SimWaitEngine sim_engine;
+	WaitEngine *old_engine;
+	long long start_ns;
+};
+
+#endif
@@ -25,95 +25,460 @@
 //=========================================================================//
 
 #include <stdio.h>
+#include <limits.h>
+#include <time.h>
 
 #ifdef __linux__
 #include <unistd.h>
+#include <errno.h>
 #include <sys/time.h>
 #endif
 
+#include <QFile>
+#include <QStringList>
+
 #include "e2cmdw.h"
 #include "busio.h"
+#include "errcode.h"
 
-Wait::Wait()
+#ifdef  CLOCK_MONOTONIC_RAW
+#define WAIT_CLOCK      CLOCK_MONOTONIC_RAW     //not slewed by NTP
+#else
+#define WAIT_CLOCK      CLOCK_MONOTONIC
+#endif
+
+#define MAX_CLOCK_OVERHEAD      8000    //nsec, same limit of the old gettimeofday() check
+
+#ifdef  Q_OS_WIN32
+#define SLEEP_PROBE_USEC        1000    //Sleep() has msec granularity
+#else
+#define SLEEP_PROBE_USEC        100
+#endif
+
+#define SPIN_GUARD_NSEC         20000   //always spin at least the last 20 usec
+
+#define CAL_LOOP_NSEC           4000000 //length of a delay loop calibration sample
+
+static inline void cpu_relax()
 {
-	if (htimer == -1)
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+	__builtin_ia32_pause();
+#endif
+}
+
+#ifdef  Q_OS_WIN32
+static LARGE_INTEGER perf_freq;
+#endif
+
+static inline long long ReadClock()
+{
+#ifdef  Q_OS_WIN32
+	LARGE_INTEGER c;
+
+	if (perf_freq.QuadPart == 0)
 	{
-		CheckHwTimer();
+		QueryPerformanceFrequency(&perf_freq);
 	}
+
+	QueryPerformanceCounter(&c);
+
+	return (c.QuadPart / perf_freq.QuadPart) * 1000000000LL +
+		   (c.QuadPart % perf_freq.QuadPart) * 1000000000LL / perf_freq.QuadPart;
+#else
+	struct timespec ts;
+
+	clock_gettime(WAIT_CLOCK, &ts);
+
+	return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+#endif
 }
 
-Wait::~Wait()
+static void SleepFor(long long nsec)
 {
-}
+#ifdef  Q_OS_WIN32
+	Sleep((DWORD)(nsec / 1000000));
+#else
+	struct timespec ts;
 
-int Wait::bogokips = 0;
-int Wait::htimer = -1;
+	ts.tv_sec = nsec / 1000000000LL;
+	ts.tv_nsec = nsec % 1000000000LL;
 
-#ifdef  Q_OS_WIN32
-LARGE_INTEGER Wait::mlpf;
+# ifdef __linux__
+
+	while (clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, &ts) == EINTR)
+		;
+
+# else
+
+	while (nanosleep(&ts, &ts) == -1 && errno == EINTR)
+		;
+
+# endif
 #endif
+}
 
-//Check for a good hardware usec timer
-int Wait::CheckHwTimer()
+//High resolution engine: CLOCK_MONOTONIC_RAW on Linux (read through the vDSO,
+// TSC based on x86), QueryPerformanceCounter on Windows.
+//Short delays spin on the clock, longer ones sleep and spin only the tail.
+class ClockWaitEngine : public WaitEngine
 {
-#ifdef  Q_OS_WIN32
-	LARGE_INTEGER i1, i2;
+  public:
+	ClockWaitEngine()
+		: overhead(0),
+		  sleep_slack(0)
+	{
+	}
+
+	const char *GetName() const
+	{
+		return "clock";
+	}
 
-	htimer = 0;                                                             //Disable by default
+	int Calibrate();
+	void Delay(long usec);
 
-	if (QueryPerformanceFrequency(&mlpf))           //return ticks per second if hw support high resolution timer
+	long GetOverhead() const
 	{
-		long usec = (long)(8 * mlpf.QuadPart / 1000000);        //test with 5 usec
+		return (long)overhead;
+	}
+	long GetSleepSlack() const
+	{
+		return (long)sleep_slack;
+	}
+	void SetParams(long ovh, long slack)
+	{
+		overhead = ovh;
+		sleep_slack = slack;
+	}
+
+  private:
+	long long overhead;             //cost of a clock read (nsec)
+	long long sleep_slack;          //how much a sleep overshoots the request (nsec)
+};
+
+int ClockWaitEngine::Calibrate()
+{
+	long long t1, t2;
+	int k;
+
+	//Clock read overhead: best of back to back reads
+	overhead = LLONG_MAX;
 
-		int k;
+	for (k = 0; k < 64; k++)
+	{
+		t1 = ReadClock();
+		t2 = ReadClock();
 
-		for (k = 0; k < 50; k++)
+		if (t2 - t1 < overhead)
 		{
-			QueryPerformanceCounter(&i1);
-			QueryPerformanceCounter(&i2);
+			overhead = t2 - t1;
+		}
+	}
 
-			if ((i2.QuadPart - i1.QuadPart) < usec)
-			{
-				htimer = 1;             //Enable for fast computers
-				break;
-			}
+	if (overhead >= MAX_CLOCK_OVERHEAD)
+	{
+		return 0;
+	}
+
+	//Sleep latency: average overshoot of a few short sleeps
+	sleep_slack = 0;
+
+	for (k = 0; k < 4; k++)
+	{
+		t1 = ReadClock();
+		SleepFor(SLEEP_PROBE_USEC * 1000LL);
+		sleep_slack += ReadClock() - t1 - SLEEP_PROBE_USEC * 1000LL;
+	}
+
+	sleep_slack /= 4;
+
+	qDebug() << "ClockWaitEngine::Calibrate() overhead =" << overhead << "ns, sleep slack =" << sleep_slack << "ns";
+
+	return 1;
+}
+
+void ClockWaitEngine::Delay(long usec)
+{
+	long long t0 = ReadClock();
+	long long deadline = t0 + usec * 1000LL - overhead;
+	long long margin = sleep_slack + sleep_slack / 2 + SPIN_GUARD_NSEC;
+
+	if (deadline - t0 > 2 * margin)
+	{
+		long long req = deadline - t0 - margin;
+
+		SleepFor(req);
+
+		//Follow the sleep latency: raise the margin fast, lower it slowly
+		long long over = ReadClock() - t0 - req;
+
+		if (over > sleep_slack)
+		{
+			sleep_slack += (over - sleep_slack) / 2;
+		}
+		else
+		{
+			sleep_slack -= (sleep_slack - over) / 8;
 		}
 	}
 
-#else
-	struct timeval t1, t2;
+	while (ReadClock() < deadline)
+	{
+		cpu_relax();
+	}
+}
+
+/* Switch optimization OFF, so the compiler don't remove
+ * the wait loop
+ */
+#ifndef __GNUC__
+#pragma optimize( "", off )
+#endif
+
+//Fallback engine for machines without a usable clock: a loop calibrated in BogoKips
+class LoopWaitEngine : public WaitEngine
+{
+  public:
+	LoopWaitEngine()
+		: bogokips(0)
+	{
+	}
 
-	htimer = 0;             //Disable by default
+	const char *GetName() const
+	{
+		return "loop";
+	}
+
+	int Calibrate()
+	{
+		return 1;
+	}
+
+	void Delay(long usec)
+	{
+		Spin(usec * bogokips / 1000);
+	}
 
+	void Spin(long n)
+	{
+		volatile long k = n;
+
+		while (k--)
+			;
+	}
+
+	void SetBogoKips(int val)
+	{
+		bogokips = val;
+	}
+
+  private:
+	int bogokips;
+};
+
+#ifndef __GNUC__
+#pragma optimize( "", on )
+#endif
+
+static ClockWaitEngine clock_engine;
+static LoopWaitEngine loop_engine;
+
+//Time the delay loop against the clock, return iterations per msec (BogoKips)
+static int MeasureLoopRate()
+{
+	long n = 1000;
+	long long dt, t0;
 	int k;
 
-	for (k = 0; k < 50; k++)
+	//Double the sample until it lasts CAL_LOOP_NSEC, this also wakes up the CPU clock
+	for (;;)
 	{
-		gettimeofday(&t1, NULL);
-		gettimeofday(&t2, NULL);
-		timersub(&t2, &t1, &t1);
+		t0 = ReadClock();
+		loop_engine.Spin(n);
+		dt = ReadClock() - t0;
 
-		if (t1.tv_usec < 8)
+		if (dt >= CAL_LOOP_NSEC || n >= LONG_MAX / 2)
 		{
-			htimer = 1;             //Enable for fast computers
 			break;
 		}
+
+		n *= 2;
+	}
+
+	//Keep the fastest run, a preempted one only lasts longer
+	for (k = 0; k < 3; k++)
+	{
+		t0 = ReadClock();
+		loop_engine.Spin(n);
+		long long d = ReadClock() - t0;
+
+		if (d < dt)
+		{
+			dt = d;
+		}
+	}
+
+	if (dt <= 0)
+	{
+		return 0;
+	}
+
+	return (int)(n * 1000000LL / dt);
+}
+
+#ifdef  __linux__
+//Return the value of the first line starting with one of the keys
+// (the whole first line if keys is empty)
+static QString ReadSysValue(const char *fname, const QStringList &keys = QStringList())
+{
+	QFile fh(fname);
+	QByteArray line;
+
+	if (!fh.open(QIODevice::ReadOnly | QIODevice::Text))
+	{
+		return QString();
+	}
+
+	//don't trust atEnd(), /proc and /sys files report size 0
+	while (!(line = fh.readLine()).isEmpty())
+	{
+		QString str = QString(line).trimmed();
+
+		if (keys.isEmpty())
+		{
+			return str;
+		}
+
+		for (int k = 0; k < keys.count(); k++)
+		{
+			if (str.startsWith(keys.at(k)))
+			{
+				return str.section(':', 1).trimmed();
+			}
+		}
 	}
 
+	return QString();
+}
+#endif
+
+//The timing profile depends on the CPU model, the frequency governor and the clock source
+QString Wait::GetCpuSignature()
+{
+	QString model, governor, clocksrc;
+
+#ifdef  __linux__
+	model = ReadSysValue("/proc/cpuinfo", QStringList() << "model name" << "Hardware" << "cpu model");
+	governor = ReadSysValue("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor");
+	clocksrc = ReadSysValue("/sys/devices/system/clocksource/clocksource0/current_clocksource");
+#else
+# ifdef Q_OS_WIN32
+	model = QString(qgetenv("PROCESSOR_IDENTIFIER"));
+# endif
 #endif
 
+	return model + "|" + governor + "|" + clocksrc;
+}
+
+Wait::Wait()
+{
+	if (htimer == -1)
+	{
+		if (Calibrate() != OK)
+		{
+			CheckHwTimer();
+		}
+	}
+}
+
+Wait::~Wait()
+{
+}
+
+int Wait::bogokips = 0;
+int Wait::htimer = -1;
+WaitEngine *Wait::engine = 0;
+
+//Check for a good hardware usec timer
+int Wait::CheckHwTimer()
+{
+	if (clock_engine.Calibrate())
+	{
+		htimer = 1;             //Enable for fast computers
+		engine = &clock_engine;
+	}
+	else
+	{
+		htimer = 0;
+		GetBogoKips();
+		engine = &loop_engine;
+	}
+
+	qDebug() << "Wait::CheckHwTimer() engine =" << engine->GetName();
+
 	return htimer;
 }
 
+int Wait::Calibrate(bool force)
+{
+	QString sig = GetCpuSignature();
+	TimingProfile prof;
+
+	if (!force && E2Profile::GetTimingProfile(sig, prof))
+	{
+		qDebug() << "Wait::Calibrate() profile of" << sig << ": bogokips =" << prof.bogokips << ", hwtimer =" << prof.hwtimer;
+	}
+	else
+	{
+		long long t0 = ReadClock();
+
+		prof.bogokips = MeasureLoopRate();
+		prof.hwtimer = clock_engine.Calibrate();
+		prof.clock_overhead = clock_engine.GetOverhead();
+		prof.sleep_slack = clock_engine.GetSleepSlack();
+
+		qDebug() << "Wait::Calibrate() new profile of" << sig << ": bogokips =" << prof.bogokips << ", hwtimer =" << prof.hwtimer
+				 << "(" << (ReadClock() - t0) / 1000000 << "ms)";
+
+		if (prof.bogokips <= 0)
+		{
+			return NOT_READY;
+		}
+
+		E2Profile::SetTimingProfile(sig, prof);
+		E2Profile::SetBogoMips(prof.bogokips);
+	}
+
+	bogokips = prof.bogokips;
+	loop_engine.SetBogoKips(bogokips);
+
+	if (prof.hwtimer)
+	{
+		clock_engine.SetParams(prof.clock_overhead, prof.sleep_slack);
+		htimer = 1;
+		engine = &clock_engine;
+	}
+	else
+	{
+		htimer = 0;
+		engine = &loop_engine;
+	}
+
+	return OK;
+}
+
 void Wait::SetHwTimer(int ok)
 {
 	if (ok == 1)
 	{
 		htimer = 1;
+		engine = &clock_engine;
 	}
 	else if (ok == 0)
 	{
 		htimer = 0;
+		GetBogoKips();
+		engine = &loop_engine;
 	}
 	else
 	{
@@ -121,9 +486,28 @@ void Wait::SetHwTimer(int ok)
 	}
 }
 
+void Wait::SetEngine(WaitEngine *eng)
+{
+	if (eng && eng->Calibrate())
+	{
+		engine = eng;
+		htimer = (eng == &loop_engine) ? 0 : 1;
+	}
+}
+
+void Wait::RestoreEngine(WaitEngine *eng)
+{
+	if (eng)
+	{
+		engine = eng;
+		htimer = (eng == &loop_engine) ? 0 : 1;
+	}
+}
+
 void Wait::SetBogoKips()
 {
 	Wait::bogokips = E2Profile::GetBogoMips();
+	loop_engine.SetBogoKips(Wait::bogokips);
 }
 
 inline int Wait::GetBogoKips()
@@ -136,8 +520,19 @@ inline int Wait::GetBogoKips()
 	return Wait::bogokips;
 }
 
+long long Wait::GetTimestamp()
+{
+	return ReadClock();
+}
+
 void Wait::WaitMsec(int msec)
 {
+	if (engine && engine->IsVirtual())
+	{
+		engine->Delay((long)msec * 1000);
+		return;
+	}
+
 #ifdef __linux__
 	usleep(msec * 1000);
 #else
@@ -156,51 +551,67 @@ void Wait::WaitMsec(int msec)
 #endif
 }
 
-/* Switch optimization OFF, so the compiler don't remove
- * the wait loop
- */
-#ifndef __GNUC__
-#pragma optimize( "", off )
-#endif
-
 void Wait::WaitUsec(int usec)
 {
-	if (htimer)
+	if (usec > 0)
 	{
-#ifdef  Q_OS_WIN32
-		LARGE_INTEGER i1, i2;
+		engine->Delay(usec);
+	}
+}
 
-		QueryPerformanceCounter(&i1);
+//Measure the delay really achieved by WaitUsec() for every res[k].usec requested.
+//Return the worst average error in percent of the requested delay.
+int Wait::SelfTest(WaitTestResult *res, int nres, int nloops)
+{
+	int worst = 0;
+	int k;
+
+	for (k = 0; k < nres; k++)
+	{
+		long long sum = 0;
+		int j;
 
-		long i_usec = (long)(usec * mlpf.QuadPart / 1000000);
+		res[k].min_ns = LONG_MAX;
+		res[k].max_ns = 0;
 
-		do
+		for (j = 0; j < nloops; j++)
 		{
-			QueryPerformanceCounter(&i2);
-		}
-		while ((long)(i2.QuadPart - i1.QuadPart) < i_usec);
+			long long t0 = GetTimestamp();
+			WaitUsec(res[k].usec);
+			long dt = (long)(GetTimestamp() - t0);
 
-#else
-		struct timeval t1, t2;
+			sum += dt;
 
-		gettimeofday(&t1, NULL);
-		t2.tv_sec = 0;
-		t2.tv_usec = usec;
-		timeradd(&t1, &t2, &t1);
+			if (dt < res[k].min_ns)
+			{
+				res[k].min_ns = dt;
+			}
 
-		do
+			if (dt > res[k].max_ns)
+			{
+				res[k].max_ns = dt;
+			}
+		}
+
+		res[k].avg_ns = (long)(sum / (nloops > 0 ? nloops : 1));
+
+		if (res[k].usec > 0)
 		{
-			gettimeofday(&t2, NULL);
+			int err = (int)((res[k].avg_ns - res[k].usec * 1000LL) * 100 / (res[k].usec * 1000LL));
+
+			if (err < 0)
+			{
+				err = -err;
+			}
+
+			if (err > worst)
+			{
+				worst = err;
+			}
 		}
-		while (timercmp(&t2, &t1, <));  // EK 2017 is it right???
 
-#endif
+		qDebug() << "Wait::SelfTest()" << res[k].usec << "us: min =" << res[k].min_ns << ", avg =" << res[k].avg_ns << ", max =" << res[k].max_ns << "ns";
 	}
-	else
-	{
-		volatile int k = usec * GetBogoKips() / 1000;
 
-		while (k--)
-			;
-	}
+	return worst;
 }
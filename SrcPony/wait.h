@@ -27,10 +27,45 @@
 #ifndef _WAIT_H
 #define _WAIT_H
 
+#include <QString>
+
 #ifdef  Q_OS_WIN32
 #include "windows.h"
 #endif
 
+//Timing engine used by Wait. An engine owns the clock source and the
+// delay primitive, Wait selects the best one available at runtime.
+class WaitEngine
+{
+  public:               //---------------------------------------- public
+
+	virtual ~WaitEngine()
+	{
+	}
+
+	virtual const char *GetName() const = 0;
+
+	//Measure clock overhead and sleep latency, return 0 if the engine is unusable
+	virtual int Calibrate() = 0;
+
+	virtual void Delay(long usec) = 0;
+
+	//A virtual engine only accounts the time, WaitMsec() goes through it too
+	virtual bool IsVirtual() const
+	{
+		return false;
+	}
+};
+
+//Result of Wait::SelfTest() for a single requested delay
+struct WaitTestResult
+{
+	int usec;               //requested delay
+	long min_ns;            //achieved delay (nanoseconds)
+	long avg_ns;
+	long max_ns;
+};
+
 class Wait
 {
   public:               //---------------------------------------- public
@@ -50,6 +85,24 @@ class Wait
 	void SetHwTimer(int ok = -1);
 	int CheckHwTimer();
 
+	//Load the timing profile of this machine, measure it again if missing,
+	// stale or force is set. Run by the first Wait constructed.
+	int Calibrate(bool force = false);
+	static QString GetCpuSignature();
+
+	static WaitEngine *GetEngine()
+	{
+		return engine;
+	}
+	static void SetEngine(WaitEngine *eng);
+	//Put back an engine saved with GetEngine(), it's not calibrated again
+	static void RestoreEngine(WaitEngine *eng);
+
+	//Monotonic timestamp in nanoseconds, used as reference by SelfTest()
+	static long long GetTimestamp();
+
+	int SelfTest(WaitTestResult *res, int nres, int nloops = 20);
+
   protected:    //--------------------------------------- protected
 
 	int GetBogoKips();
@@ -59,8 +112,6 @@ class Wait
 	static int bogokips;
 	static int htimer;
 
-#ifdef  Q_OS_WIN32
-	static LARGE_INTEGER mlpf;
-#endif
+	static WaitEngine *engine;
 };
 #endif
@@ -118,12 +118,9 @@ long X2444Bus::Read(int addr, uint8_t *data, long length, int page_size)
 
 		WaitUsec(1);
 
-		if ((len & 1))
+		if (ReadProgress(len, length))
 		{
-			if (ReadProgress(len * 100 / length))
-			{
-				break;
-			}
+			break;
 		}
 	}
 
@@ -195,7 +192,7 @@ long X2444Bus::Write(int addr, uint8_t const *data, long length, int page_size)
 
 		if ((curaddr & 1))
 		{
-			if (WriteProgress(curaddr * 100 / length))
+			if (WriteProgress(curaddr, length))
 			{
 				break;
 			}
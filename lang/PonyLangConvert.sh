@@ -349,7 +349,9 @@ array=( "STR_LANGUAGE_CODE"
 
 "STR_LBLFUSEDLGHLP"
 "STR_FUSEDLGNOTESET"
-"STR_FUSEDLGNOTECLR" )
+"STR_FUSEDLGNOTECLR"
+
+"STR_LBLSPIMINTIMING" )
 
 
 for f in $(find . -type f \( -name "string_table*.h" \));
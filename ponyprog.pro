@@ -148,6 +148,13 @@ SOURCES  += SrcPony/aboutmdlg.cpp \
             SrcPony/eeptypes.cpp \
             SrcPony/imbus.cpp \
             SrcPony/linuxsysfsint.cpp \
+            SrcPony/linuxgpiochipint.cpp \
+            SrcPony/linuxgpiomemint.cpp \
+            SrcPony/bustrace.cpp \
+            SrcPony/simtarget.cpp \
+            SrcPony/virtualint.cpp \
+            SrcPony/progworker.cpp \
+            SrcPony/e2bufdev.cpp \
             SrcPony/pic12bus.cpp \
             SrcPony/ponyioint.cpp \
             SrcPony/rs232int.cpp \
@@ -222,6 +229,13 @@ HEADERS  += SrcPony/e2app.h \
             SrcPony/filebuf.h \
             SrcPony/imbus.h \
             SrcPony/linuxsysfsint.h \
+            SrcPony/linuxgpiochipint.h \
+            SrcPony/linuxgpiomemint.h \
+            SrcPony/bustrace.h \
+            SrcPony/simtarget.h \
+            SrcPony/virtualint.h \
+            SrcPony/progworker.h \
+            SrcPony/e2bufdev.h \
             SrcPony/pic12bus.h \
             SrcPony/ponyioint.h \
             SrcPony/resource.h \
@@ -313,6 +327,9 @@ CONFIG(debug, debug|release) {
     DEFINES += QT_NO_DEBUG_OUTPUT QT_USE_FAST_CONCATENATION QT_USE_FAST_OPERATOR_PLUS
 }
 
+# bus pin trace (VCD dump) and per-edge debug lines
+#DEFINES += ENABLE_BUSTRACE ENABLE_EDGE_DEBUG
+
 # -Wall are already on the command line (where does it come from?)
 # for old GCC -std=c++11 move to -std=c++0x
 QMAKE_CXXFLAGS += -Wno-unused-parameter